@@ -0,0 +1,599 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "object_pool.h"
+#include "sharded_pool.h"
+#include "cli_logger.h"
+
+/**
+ * @file bench_object_pool.c
+ * @brief Multi-threaded acquire/release benchmark for the object pool.
+ *
+ * Every configuration in the cross product of allocators, thread counts,
+ * object sizes, batch sizes and occupancy levels runs two phases: an untimed
+ * loop for throughput, then a loop that timestamps each round for latency
+ * percentiles. A round acquires `batch` objects, writes to each of them and
+ * releases them again. Results go to stdout (or --output) as CSV or JSON.
+ */
+
+#define MAX_LIST 16
+#define THREAD_CACHE_SIZE 64
+#define MIN_POOL_SIZE 1024
+
+// Allocators under test
+typedef enum
+{
+    BENCH_MALLOC,
+    BENCH_POOL_MUTEX,
+    BENCH_POOL_LOCK_FREE,
+    BENCH_POOL_THREAD_CACHE,
+    BENCH_POOL_SHARDED,
+    BENCH_ALLOCATOR_COUNT
+} BenchAllocator;
+
+static const char *allocator_names[BENCH_ALLOCATOR_COUNT] = {
+    "malloc", "pool_mutex", "pool_lock_free", "pool_thread_cache", "pool_sharded"};
+
+// One point in the configuration space
+typedef struct
+{
+    BenchAllocator allocator;
+    size_t threads;
+    size_t object_size;
+    size_t batch;
+    size_t occupancy; /**< Percentage of the pool held by the main thread during the run */
+    size_t rounds;    /**< Acquire/release rounds per thread and phase */
+} BenchCase;
+
+// Measured results for one configuration
+typedef struct
+{
+    double seconds;
+    double objects_per_sec;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    size_t failures;
+} BenchResult;
+
+// State shared by the worker threads of one run
+typedef struct
+{
+    const BenchCase *config;
+    ObjectPool *pool;
+    ShardedPool *sharded;
+    pthread_barrier_t barrier;
+} BenchShared;
+
+// Per-thread state
+typedef struct
+{
+    BenchShared *shared;
+    uint64_t *samples;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    size_t failures;
+    pthread_t thread;
+} BenchWorker;
+
+// Parsed command line
+typedef struct
+{
+    size_t threads[MAX_LIST], thread_count;
+    size_t sizes[MAX_LIST], size_count;
+    size_t batches[MAX_LIST], batch_count;
+    size_t occupancies[MAX_LIST], occupancy_count;
+    bool allocators[BENCH_ALLOCATOR_COUNT];
+    size_t rounds;
+    bool json;
+    const char *output;
+} BenchOptions;
+
+// Helper function to read the monotonic clock in nanoseconds
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Helper function to acquire up to `batch` objects; returns how many were acquired
+static size_t bench_acquire(const BenchShared *shared, void **objects)
+{
+    const BenchCase *config = shared->config;
+    ObjectPool *pool = shared->pool;
+    if (config->allocator == BENCH_MALLOC)
+    {
+        for (size_t i = 0; i < config->batch; i++)
+        {
+            objects[i] = malloc(config->object_size);
+        }
+        return config->batch;
+    }
+
+    if (config->allocator == BENCH_POOL_SHARDED)
+    {
+        size_t acquired = 0;
+        while (acquired < config->batch && (objects[acquired] = sharded_pool_acquire(shared->sharded)) != NULL)
+        {
+            acquired++;
+        }
+        return acquired;
+    }
+
+    if (config->batch == 1)
+    {
+        objects[0] = object_pool_acquire(pool);
+        return objects[0] ? 1 : 0;
+    }
+    return object_pool_acquire_n(pool, objects, config->batch);
+}
+
+// Helper function to release the objects of one round
+static void bench_release(const BenchShared *shared, void **objects, size_t count)
+{
+    const BenchCase *config = shared->config;
+    ObjectPool *pool = shared->pool;
+    if (config->allocator == BENCH_MALLOC)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            free(objects[i]);
+        }
+        return;
+    }
+
+    if (config->allocator == BENCH_POOL_SHARDED)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            sharded_pool_release(shared->sharded, objects[i]);
+        }
+        return;
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+    if (count == 1)
+    {
+        object_pool_release(pool, objects[0]);
+        return;
+    }
+    object_pool_release_n(pool, objects, count);
+}
+
+// Helper function to run one acquire/touch/release round
+static size_t bench_round(const BenchShared *shared, void **objects)
+{
+    size_t acquired = bench_acquire(shared, objects);
+    for (size_t i = 0; i < acquired; i++)
+    {
+        *(volatile char *)objects[i] = (char)i;
+    }
+    bench_release(shared, objects, acquired);
+    return acquired;
+}
+
+// Worker thread: a throughput phase followed by a latency phase
+static void *bench_worker(void *arg)
+{
+    BenchWorker *worker = arg;
+    BenchShared *shared = worker->shared;
+    const BenchCase *config = shared->config;
+    void *objects[config->batch];
+
+    pthread_barrier_wait(&shared->barrier);
+    worker->start_ns = now_ns();
+    for (size_t r = 0; r < config->rounds; r++)
+    {
+        worker->failures += config->batch - bench_round(shared, objects);
+    }
+    worker->end_ns = now_ns();
+
+    pthread_barrier_wait(&shared->barrier);
+    for (size_t r = 0; r < config->rounds; r++)
+    {
+        uint64_t start = now_ns();
+        worker->failures += config->batch - bench_round(shared, objects);
+        worker->samples[r] = now_ns() - start;
+    }
+
+    if (config->allocator == BENCH_POOL_THREAD_CACHE)
+    {
+        object_pool_thread_cache_flush(shared->pool);
+    }
+    return NULL;
+}
+
+// Helper function to order latency samples
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Helper function to pick a percentile from sorted samples
+static uint64_t percentile(const uint64_t *sorted, size_t count, double fraction)
+{
+    size_t rank = (size_t)(fraction * (double)(count - 1) + 0.5);
+    return sorted[rank];
+}
+
+// Helper function to create the pool for a configuration
+static bool bench_create_pool(BenchShared *shared, size_t *pool_size)
+{
+    const BenchCase *config = shared->config;
+
+    // Size the pool so workers never exhaust it, then scale it so `occupancy`
+    // percent of it can be held by the main thread during the run
+    size_t cache = config->allocator == BENCH_POOL_THREAD_CACHE ? THREAD_CACHE_SIZE : 0;
+    size_t free_needed = config->threads * (config->batch + cache) * 2;
+    if (free_needed < MIN_POOL_SIZE)
+    {
+        free_needed = MIN_POOL_SIZE;
+    }
+    *pool_size = free_needed * 100 / (100 - config->occupancy);
+
+    if (config->allocator == BENCH_POOL_SHARDED)
+    {
+        ShardedPoolConfig sharded_config = {0};
+        sharded_config.total_size = *pool_size;
+        sharded_config.object_size = config->object_size;
+        return sharded_pool_init(&shared->sharded, &sharded_config);
+    }
+
+    ObjectPoolConfig pool_config = {0};
+    pool_config.initial_size = *pool_size;
+    pool_config.object_size = config->object_size;
+    pool_config.mode = config->allocator == BENCH_POOL_LOCK_FREE ? OBJECT_POOL_MODE_LOCK_FREE
+                                                                 : OBJECT_POOL_MODE_MUTEX;
+    pool_config.thread_cache_size = cache;
+
+    return object_pool_init_ex(&shared->pool, &pool_config);
+}
+
+// Runs one configuration; returns false if it could not be set up
+static bool bench_run(const BenchCase *config, BenchResult *result)
+{
+    BenchShared shared = {.config = config};
+    size_t pool_size = 0;
+    size_t held_count = 0;
+    void **held = NULL;
+
+    if (config->allocator != BENCH_MALLOC)
+    {
+        if (!bench_create_pool(&shared, &pool_size))
+        {
+            return false;
+        }
+
+        held_count = pool_size * config->occupancy / 100;
+        held = malloc((held_count + 1) * sizeof(void *));
+        if (shared.sharded)
+        {
+            for (size_t i = 0; i < held_count; i++)
+            {
+                held[i] = sharded_pool_acquire(shared.sharded);
+            }
+        }
+        else
+        {
+            held_count = object_pool_acquire_n(shared.pool, held, held_count);
+        }
+        if (config->allocator == BENCH_POOL_THREAD_CACHE)
+        {
+            object_pool_thread_cache_flush(shared.pool);
+        }
+    }
+
+    BenchWorker *workers = calloc(config->threads, sizeof(BenchWorker));
+    uint64_t *samples = malloc(config->threads * config->rounds * sizeof(uint64_t));
+    pthread_barrier_init(&shared.barrier, NULL, (unsigned)config->threads + 1);
+
+    for (size_t t = 0; t < config->threads; t++)
+    {
+        workers[t].shared = &shared;
+        workers[t].samples = samples + t * config->rounds;
+        pthread_create(&workers[t].thread, NULL, bench_worker, &workers[t]);
+    }
+
+    // Start the throughput phase, then the latency phase once every worker has finished it
+    pthread_barrier_wait(&shared.barrier);
+    pthread_barrier_wait(&shared.barrier);
+
+    // Throughput spans the earliest start to the latest finish of the first phase
+    uint64_t start = UINT64_MAX;
+    uint64_t end = 0;
+    result->failures = 0;
+    for (size_t t = 0; t < config->threads; t++)
+    {
+        pthread_join(workers[t].thread, NULL);
+        start = workers[t].start_ns < start ? workers[t].start_ns : start;
+        end = workers[t].end_ns > end ? workers[t].end_ns : end;
+        result->failures += workers[t].failures;
+    }
+    uint64_t elapsed = end - start;
+
+    size_t sample_count = config->threads * config->rounds;
+    qsort(samples, sample_count, sizeof(uint64_t), compare_u64);
+    result->seconds = (double)elapsed / 1e9;
+    result->objects_per_sec = (double)(config->threads * config->rounds * config->batch) / result->seconds;
+    result->p50_ns = percentile(samples, sample_count, 0.50);
+    result->p99_ns = percentile(samples, sample_count, 0.99);
+    result->p999_ns = percentile(samples, sample_count, 0.999);
+
+    pthread_barrier_destroy(&shared.barrier);
+    free(samples);
+    free(workers);
+
+    if (shared.pool)
+    {
+        object_pool_release_n(shared.pool, held, held_count);
+        object_pool_destroy(shared.pool);
+    }
+    if (shared.sharded)
+    {
+        for (size_t i = 0; i < held_count; i++)
+        {
+            sharded_pool_release(shared.sharded, held[i]);
+        }
+        sharded_pool_destroy(shared.sharded);
+    }
+    free(held);
+    return true;
+}
+
+// Helper function to write one result row
+static void print_result(FILE *out, bool json, bool first, const BenchCase *config, const BenchResult *result)
+{
+    if (json)
+    {
+        fprintf(out,
+                "%s\n  {\"allocator\": \"%s\", \"threads\": %zu, \"object_size\": %zu, \"batch\": %zu, "
+                "\"occupancy\": %zu, \"rounds\": %zu, \"seconds\": %.6f, \"objects_per_sec\": %.0f, "
+                "\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"failures\": %zu}",
+                first ? "" : ",", allocator_names[config->allocator], config->threads, config->object_size,
+                config->batch, config->occupancy, config->rounds, result->seconds, result->objects_per_sec,
+                (unsigned long long)result->p50_ns, (unsigned long long)result->p99_ns,
+                (unsigned long long)result->p999_ns, result->failures);
+        return;
+    }
+
+    fprintf(out, "%s,%zu,%zu,%zu,%zu,%zu,%.6f,%.0f,%llu,%llu,%llu,%zu\n",
+            allocator_names[config->allocator], config->threads, config->object_size, config->batch,
+            config->occupancy, config->rounds, result->seconds, result->objects_per_sec,
+            (unsigned long long)result->p50_ns, (unsigned long long)result->p99_ns,
+            (unsigned long long)result->p999_ns, result->failures);
+}
+
+// Helper function to parse a comma-separated list of sizes
+static bool parse_list(const char *text, size_t *values, size_t *count, size_t min, size_t max)
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    *count = 0;
+
+    for (char *save = NULL, *token = strtok_r(buffer, ",", &save); token; token = strtok_r(NULL, ",", &save))
+    {
+        char *end;
+        unsigned long long value = strtoull(token, &end, 10);
+        if (*end != '\0' || value < min || value > max || *count == MAX_LIST)
+        {
+            return false;
+        }
+        values[(*count)++] = (size_t)value;
+    }
+    return *count > 0;
+}
+
+// Helper function to parse the allocator list
+static bool parse_allocators(const char *text, bool *selected)
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    memset(selected, 0, BENCH_ALLOCATOR_COUNT * sizeof(bool));
+
+    for (char *save = NULL, *token = strtok_r(buffer, ",", &save); token; token = strtok_r(NULL, ",", &save))
+    {
+        int found = -1;
+        for (int a = 0; a < BENCH_ALLOCATOR_COUNT; a++)
+        {
+            if (strcmp(token, allocator_names[a]) == 0)
+            {
+                found = a;
+            }
+        }
+        if (found < 0)
+        {
+            return false;
+        }
+        selected[found] = true;
+    }
+    return true;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --threads LIST      thread counts (default 1,2,4,8)\n"
+            "  --sizes LIST        object sizes in bytes (default 16,64,256)\n"
+            "  --batch LIST        objects per acquire/release round (default 1,16)\n"
+            "  --occupancy LIST    percent of the pool held during the run, 0-95 (default 0,90)\n"
+            "  --rounds N          rounds per thread and phase (default 100000)\n"
+            "  --allocators LIST   any of malloc,pool_mutex,pool_lock_free,pool_thread_cache,\n"
+            "                      pool_sharded (default all)\n"
+            "  --format csv|json   output format (default csv)\n"
+            "  --output FILE       write results to FILE instead of stdout\n",
+            program);
+}
+
+// Helper function to parse the command line
+static bool parse_options(int argc, char **argv, BenchOptions *options)
+{
+    static const size_t default_threads[] = {1, 2, 4, 8};
+    static const size_t default_sizes[] = {16, 64, 256};
+    static const size_t default_batches[] = {1, 16};
+    static const size_t default_occupancies[] = {0, 90};
+
+    memcpy(options->threads, default_threads, sizeof(default_threads));
+    options->thread_count = sizeof(default_threads) / sizeof(default_threads[0]);
+    memcpy(options->sizes, default_sizes, sizeof(default_sizes));
+    options->size_count = sizeof(default_sizes) / sizeof(default_sizes[0]);
+    memcpy(options->batches, default_batches, sizeof(default_batches));
+    options->batch_count = sizeof(default_batches) / sizeof(default_batches[0]);
+    memcpy(options->occupancies, default_occupancies, sizeof(default_occupancies));
+    options->occupancy_count = sizeof(default_occupancies) / sizeof(default_occupancies[0]);
+    for (int a = 0; a < BENCH_ALLOCATOR_COUNT; a++)
+    {
+        options->allocators[a] = true;
+    }
+    options->rounds = 100000;
+    options->json = false;
+    options->output = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok = value != NULL;
+
+        if (!ok)
+        {
+            return false;
+        }
+
+        if (strcmp(argv[i], "--threads") == 0)
+        {
+            ok = parse_list(value, options->threads, &options->thread_count, 1, 1024);
+        }
+        else if (strcmp(argv[i], "--sizes") == 0)
+        {
+            ok = parse_list(value, options->sizes, &options->size_count, 1, 1 << 20);
+        }
+        else if (strcmp(argv[i], "--batch") == 0)
+        {
+            ok = parse_list(value, options->batches, &options->batch_count, 1, 4096);
+        }
+        else if (strcmp(argv[i], "--occupancy") == 0)
+        {
+            ok = parse_list(value, options->occupancies, &options->occupancy_count, 0, 95);
+        }
+        else if (strcmp(argv[i], "--rounds") == 0)
+        {
+            size_t count;
+            ok = parse_list(value, &options->rounds, &count, 1, 100000000) && count == 1;
+        }
+        else if (strcmp(argv[i], "--allocators") == 0)
+        {
+            ok = parse_allocators(value, options->allocators);
+        }
+        else if (strcmp(argv[i], "--format") == 0)
+        {
+            options->json = strcmp(value, "json") == 0;
+            ok = options->json || strcmp(value, "csv") == 0;
+        }
+        else if (strcmp(argv[i], "--output") == 0)
+        {
+            options->output = value;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (!parse_options(argc, argv, &options))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *out = options.output ? fopen(options.output, "w") : stdout;
+    if (!out)
+    {
+        log_error("Failed to open %s for writing.", options.output);
+        return 1;
+    }
+
+    // The pool logs every operation at info level; keep only errors out of the measurements
+    log_set_level(LOG_LEVEL_ERROR);
+
+    if (options.json)
+    {
+        fprintf(out, "[");
+    }
+    else
+    {
+        fprintf(out, "allocator,threads,object_size,batch,occupancy,rounds,seconds,objects_per_sec,"
+                     "p50_ns,p99_ns,p999_ns,failures\n");
+    }
+
+    bool first = true;
+    for (int a = 0; a < BENCH_ALLOCATOR_COUNT; a++)
+    {
+        if (!options.allocators[a])
+        {
+            continue;
+        }
+        for (size_t t = 0; t < options.thread_count; t++)
+        {
+            for (size_t s = 0; s < options.size_count; s++)
+            {
+                for (size_t b = 0; b < options.batch_count; b++)
+                {
+                    for (size_t o = 0; o < options.occupancy_count; o++)
+                    {
+                        // Occupancy only shapes pool state; malloc runs once per shape
+                        if (a == BENCH_MALLOC && o > 0)
+                        {
+                            continue;
+                        }
+
+                        BenchCase config = {(BenchAllocator)a, options.threads[t], options.sizes[s],
+                                            options.batches[b], a == BENCH_MALLOC ? 0 : options.occupancies[o],
+                                            options.rounds};
+                        BenchResult result;
+                        if (!bench_run(&config, &result))
+                        {
+                            log_error("Failed to set up %s with %zu threads.", allocator_names[a], config.threads);
+                            continue;
+                        }
+                        print_result(out, options.json, first, &config, &result);
+                        fflush(out);
+                        first = false;
+                    }
+                }
+            }
+        }
+    }
+
+    if (options.json)
+    {
+        fprintf(out, "\n]\n");
+    }
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return 0;
+}
@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdbool.h>
 
 /**
  * @file cli_logger.h
@@ -31,9 +32,24 @@ typedef enum
 {
     LOG_LEVEL_INFO,    /**< Informational messages */
     LOG_LEVEL_WARNING, /**< Warning messages */
-    LOG_LEVEL_ERROR    /**< Error messages */
+    LOG_LEVEL_ERROR,   /**< Error messages */
+    LOG_LEVEL_NONE     /**< Disables logging when used as a threshold */
 } LogLevel;
 
+/**
+ * @brief Lowest level compiled into the LOG_INFO/LOG_WARNING/LOG_ERROR macros.
+ *
+ * 0 keeps every level, 1 drops info, 2 keeps only errors and 3 removes all
+ * macro logging. Set it at build time, e.g. -DLOG_COMPILE_LEVEL=1.
+ */
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+// Size of one message slot in the asynchronous ring buffer, including the terminator.
+// Only asynchronous messages are cut to this length; synchronous logging has no limit.
+#define LOG_ASYNC_MESSAGE_SIZE 224
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -63,8 +79,112 @@ extern "C"
      */
     API_EXPORT void log_error(const char *format, ...);
 
+    /**
+     * @brief Sets the runtime threshold below which messages are discarded.
+     *
+     * The threshold is checked before any formatting takes place.
+     *
+     * @param level Lowest level to emit; LOG_LEVEL_NONE silences the logger.
+     */
+    API_EXPORT void log_set_level(LogLevel level);
+
+    /**
+     * @brief Returns the current runtime threshold.
+     */
+    API_EXPORT LogLevel log_get_level(void);
+
+    /**
+     * @brief Checks whether a message at the given level would be emitted.
+     *
+     * @param level The level to check.
+     * @return true if the runtime threshold lets the level through.
+     */
+    API_EXPORT bool log_level_enabled(LogLevel level);
+
+    /**
+     * @brief Switches the logger to an asynchronous ring-buffer backend.
+     *
+     * Callers format the message into a ring slot and return without taking
+     * the stdio lock; a background thread timestamps and writes the entries.
+     * When the ring is full, messages are dropped and counted rather than
+     * blocking the caller. While the backend runs, each message is truncated
+     * to LOG_ASYNC_MESSAGE_SIZE - 1 characters.
+     *
+     * @param capacity Number of ring slots, rounded up to a power of two.
+     * @return true on success, false if the backend could not be started.
+     */
+    API_EXPORT bool log_async_start(size_t capacity);
+
+    /**
+     * @brief Drains the ring buffer, stops the background thread and returns
+     *        to synchronous logging.
+     */
+    API_EXPORT void log_async_stop(void);
+
 #ifdef __cplusplus
 }
 #endif
 
+// Level-filtered logging macros; arguments are only evaluated when the level is enabled.
+// Levels below LOG_COMPILE_LEVEL keep their arguments type-checked but generate no code.
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_INFO(...)                             \
+    do                                            \
+    {                                             \
+        if (log_level_enabled(LOG_LEVEL_INFO))    \
+        {                                         \
+            log_info(__VA_ARGS__);                \
+        }                                         \
+    } while (0)
+#else
+#define LOG_INFO(...)                             \
+    do                                            \
+    {                                             \
+        if (0)                                    \
+        {                                         \
+            log_info(__VA_ARGS__);                \
+        }                                         \
+    } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_WARNING(...)                          \
+    do                                            \
+    {                                             \
+        if (log_level_enabled(LOG_LEVEL_WARNING)) \
+        {                                         \
+            log_warning(__VA_ARGS__);             \
+        }                                         \
+    } while (0)
+#else
+#define LOG_WARNING(...)                          \
+    do                                            \
+    {                                             \
+        if (0)                                    \
+        {                                         \
+            log_warning(__VA_ARGS__);             \
+        }                                         \
+    } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_ERROR(...)                            \
+    do                                            \
+    {                                             \
+        if (log_level_enabled(LOG_LEVEL_ERROR))   \
+        {                                         \
+            log_error(__VA_ARGS__);               \
+        }                                         \
+    } while (0)
+#else
+#define LOG_ERROR(...)                            \
+    do                                            \
+    {                                             \
+        if (0)                                    \
+        {                                         \
+            log_error(__VA_ARGS__);               \
+        }                                         \
+    } while (0)
+#endif
+
 #endif // CLI_LOGGER_H
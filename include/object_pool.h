@@ -3,8 +3,17 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <pthread.h>
 
+#ifdef __cplusplus
+#include <atomic>
+#define OBJECT_POOL_ATOMIC(T) std::atomic<T>
+#else
+#include <stdatomic.h>
+#define OBJECT_POOL_ATOMIC(T) _Atomic T
+#endif
+
 /**
  * @file object_pool.h
  * @brief Thread-safe Object Pool for efficient memory management.
@@ -13,17 +22,172 @@
 #ifdef __cplusplus
 extern "C"
 {
+#endif
+
+#ifndef OBJECT_POOL_MAX_CHUNKS
+#define OBJECT_POOL_MAX_CHUNKS 64 /**< Maximum number of slabs a pool can grow to */
+#endif
+
+#define OBJECT_POOL_MAX_ALIGNMENT 4096 /**< Largest supported per-object alignment */
+
+#define OBJECT_POOL_INVALID_INDEX SIZE_MAX /**< Slot index that refers to no object */
+
+#ifndef OBJECT_POOL_HANDLE_INDEX_BITS
+#define OBJECT_POOL_HANDLE_INDEX_BITS 20 /**< Low handle bits holding the slot index; the rest hold its generation */
+#endif
+
+#define OBJECT_POOL_NULL_HANDLE 0u /**< Handle that refers to no object */
+
+#ifndef OBJECT_POOL_STAT_STRIPES
+#define OBJECT_POOL_STAT_STRIPES 16 /**< Counter stripes threads spread their statistics over */
+#endif
+
+#ifndef OBJECT_POOL_LATENCY_SAMPLE_INTERVAL
+#define OBJECT_POOL_LATENCY_SAMPLE_INTERVAL 64 /**< Time one in this many acquires per thread (0 disables) */
+#endif
+
+#define OBJECT_POOL_LATENCY_BUCKETS 32 /**< Buckets in the power-of-two acquire latency histogram */
+
+#ifndef OBJECT_POOL_RETIRE_BATCH
+#define OBJECT_POOL_RETIRE_BATCH 64 /**< Retirements between automatic reclamation attempts */
+#endif
+
+#ifndef OBJECT_POOL_COMPACT_BATCH
+#define OBJECT_POOL_COMPACT_BATCH 64 /**< Objects moved per pool lock hold during compaction */
 #endif
 
     /**
-     * @struct AcquiredNode
-     * @brief Structure representing a node in the acquired objects list.
+     * @enum ObjectPoolMode
+     * @brief Synchronization strategy used by acquire and release.
      */
-    typedef struct AcquiredNode
+    typedef enum ObjectPoolMode
     {
-        void *object;
-        struct AcquiredNode *next;
-    } AcquiredNode;
+        OBJECT_POOL_MODE_MUTEX,    /**< Free list guarded by the pool mutex (default) */
+        OBJECT_POOL_MODE_LOCK_FREE /**< Lock-free Treiber stack of slot indices */
+    } ObjectPoolMode;
+
+    /**
+     * @enum ObjectPoolGrowth
+     * @brief How the pool grows when an acquire finds it empty.
+     */
+    typedef enum ObjectPoolGrowth
+    {
+        OBJECT_POOL_GROWTH_NONE,     /**< Acquire fails when the pool is empty (default) */
+        OBJECT_POOL_GROWTH_LINEAR,   /**< Add growth_step objects */
+        OBJECT_POOL_GROWTH_GEOMETRIC /**< Double the pool size */
+    } ObjectPoolGrowth;
+
+    // Callback function type for iterating over acquired objects
+    typedef void (*object_callback)(void *object, void *user_data);
+
+    // Predicate applied to acquired objects by object_pool_count_if
+    typedef bool (*object_predicate)(const void *object, void *user_data);
+
+    // Called by object_pool_compact after an object was copied to a new slot; repoint references to it
+    typedef void (*object_relocate)(void *old_object, void *new_object, void *user_data);
+
+    // Constructor run on a slot's first acquire; returning false fails the acquire
+    typedef bool (*object_constructor)(void *object, void *user_data);
+
+    // Compact reference to an acquired object: generation << OBJECT_POOL_HANDLE_INDEX_BITS | slot index
+    typedef uint32_t ObjectPoolHandle;
+
+    /**
+     * @struct ObjectPoolConfig
+     * @brief Options for object_pool_init_ex(). Zeroed fields select the defaults.
+     */
+    typedef struct ObjectPoolConfig
+    {
+        size_t initial_size;            /**< Initial number of objects in the pool */
+        size_t object_size;             /**< Size of each object in bytes */
+        size_t thread_cache_size;       /**< Per-thread cache capacity in objects (0 disables caching) */
+        ObjectPoolMode mode;            /**< Synchronization strategy */
+        ObjectPoolGrowth growth;        /**< Growth policy on exhaustion */
+        size_t growth_step;             /**< Objects added per linear growth (0 selects initial_size) */
+        size_t max_size;                /**< Upper bound on the pool size (0 for no bound) */
+        unsigned idle_shrink_ms;        /**< Free grown chunks that stay idle this long (0 disables) */
+        size_t alignment;               /**< Per-object alignment, a power of two up to OBJECT_POOL_MAX_ALIGNMENT (0 packs objects) */
+        bool huge_pages;                /**< Back chunks with mmap and request transparent huge pages */
+        bool numa_bind;                 /**< Place chunk memory on numa_node and prefault it */
+        int numa_node;                  /**< NUMA node used when numa_bind is set */
+        bool own_pages;                 /**< Back chunks with mmap so no page holds memory of two chunks */
+        object_constructor constructor; /**< Builds an object the first time its slot is acquired */
+        object_callback destructor;     /**< Tears down constructed objects when their memory is freed */
+        object_callback reset;          /**< Returns an object to a reusable state on every release */
+        void *hook_data;                /**< Passed as user_data to the lifecycle hooks */
+        bool wait_fifo;                 /**< Hand freed objects to blocked acquirers in arrival order */
+        bool handles;                   /**< Track slot generations so objects can be referred to by ObjectPoolHandle */
+    } ObjectPoolConfig;
+
+    /**
+     * @struct ObjectPoolChunk
+     * @brief A slab of objects added by object_pool_init or object_pool_resize.
+     *
+     * Chunks are never moved or reallocated, so acquired objects keep their
+     * addresses for the lifetime of the pool. A chunk released by idle
+     * shrinking keeps its slot indices and metadata with memory set to NULL,
+     * and is reallocated before any new chunk is added.
+     */
+    typedef struct ObjectPoolChunk
+    {
+        char *memory;                                     /**< Slab holding the chunk's objects */
+        size_t mapped_size;                               /**< Length of the mmap backing memory (0 if heap allocated) */
+        size_t first_index;                               /**< Pool-wide index of the chunk's first slot */
+        size_t count;                                     /**< Number of slots in the chunk */
+        uint64_t idle_since_ms;                           /**< When the chunk was first seen fully free (0 if in use) */
+        OBJECT_POOL_ATOMIC(uint64_t) *acquired_bitmap;    /**< One bit per slot, set while the slot is acquired */
+        OBJECT_POOL_ATOMIC(uint64_t) *constructed_bitmap; /**< One bit per slot holding a constructed object (lifecycle hooks only) */
+        OBJECT_POOL_ATOMIC(uint32_t) *free_next;          /**< Per-slot next free index (lock-free mode) */
+        OBJECT_POOL_ATOMIC(uint32_t) *generations;        /**< Per-slot release count (handles only) */
+    } ObjectPoolChunk;
+
+    /**
+     * @struct ObjectPoolStatStripe
+     * @brief One stripe of the pool's statistics counters.
+     *
+     * Threads are spread round-robin over the stripes so that counting stays
+     * an uncontended relaxed atomic add; object_pool_get_stats sums them.
+     */
+    typedef struct ObjectPoolStatStripe
+    {
+        OBJECT_POOL_ATOMIC(uint64_t) acquires;                                     /**< Objects handed out */
+        OBJECT_POOL_ATOMIC(uint64_t) releases;                                     /**< Objects returned */
+        OBJECT_POOL_ATOMIC(uint64_t) failed_acquires;                              /**< Objects requested from an exhausted pool */
+        OBJECT_POOL_ATOMIC(uint64_t) lock_contentions;                             /**< Lock acquisitions that had to wait */
+        OBJECT_POOL_ATOMIC(uint64_t) lock_wait_ns;                                 /**< Time spent waiting for the lock */
+        OBJECT_POOL_ATOMIC(uint64_t) acquire_latency[OBJECT_POOL_LATENCY_BUCKETS]; /**< Sampled acquire latency histogram */
+    } ObjectPoolStatStripe;
+
+    /**
+     * @struct ObjectPoolStats
+     * @brief Snapshot of a pool's counters returned by object_pool_get_stats().
+     */
+    typedef struct ObjectPoolStats
+    {
+        uint64_t acquires;                                     /**< Objects handed out */
+        uint64_t releases;                                     /**< Objects returned */
+        uint64_t failed_acquires;                              /**< Objects requested while the pool was exhausted */
+        size_t in_use;                                         /**< Objects currently acquired (acquires - releases) */
+        size_t high_water_mark;                                /**< Most objects outside the shared free list at once */
+        size_t pool_size;                                      /**< Current pool size */
+        size_t available;                                      /**< Objects on the shared free list */
+        uint64_t resizes;                                      /**< Explicit resizes plus automatic growth events */
+        uint64_t shrinks;                                      /**< Chunks freed by shrinking or compaction */
+        uint64_t relocations;                                  /**< Objects moved by compaction */
+        uint64_t lock_contentions;                             /**< Lock acquisitions that had to wait */
+        uint64_t lock_wait_ns;                                 /**< Total time spent waiting for the lock */
+        uint64_t acquire_latency[OBJECT_POOL_LATENCY_BUCKETS]; /**< Sampled acquires; bucket 0 is 0 ns, bucket i is [2^(i-1), 2^i) ns */
+        uint64_t corruptions;                                  /**< Red-zone, use-after-release and double-release errors (OBJECT_POOL_DEBUG builds) */
+    } ObjectPoolStats;
+
+    // Per-thread cache of free slots, defined in object_pool.c
+    struct ObjectPoolThreadCache;
+
+    // Thread blocked in object_pool_acquire_wait, defined in object_pool.c
+    struct ObjectPoolWaiter;
+
+    // Reader thread's announced epoch, defined in object_pool.c
+    struct ObjectPoolEpochRecord;
 
     /**
      * @struct ObjectPool
@@ -31,18 +195,57 @@ extern "C"
      */
     typedef struct ObjectPool
     {
-        void **free_list;            /**< Array of pointers to free objects */
-        size_t object_size;          /**< Size of each object */
-        size_t pool_size;            /**< Current pool size */
-        size_t available;            /**< Number of free objects */
-        void *memory_block;          /**< Pointer to the memory block */
-        pthread_mutex_t lock;        /**< Mutex for thread safety */
-        AcquiredNode *acquired_head; /**< Head of the acquired objects list */
+        size_t *free_list;                                    /**< Stack of free slot indices (mutex mode) */
+        size_t object_size;                                   /**< Size of each object */
+        size_t stride;                                        /**< Distance between consecutive objects in a chunk */
+        size_t alignment;                                     /**< Object alignment (0 for the default heap alignment) */
+        bool huge_pages;                                      /**< Chunks are mmap-backed with MADV_HUGEPAGE */
+        bool numa_bind;                                       /**< Chunks are bound to numa_node */
+        int numa_node;                                        /**< NUMA node chunk memory is placed on */
+        bool own_pages;                                       /**< Chunks are mmap-backed on page boundaries */
+        OBJECT_POOL_ATOMIC(size_t) pool_size;                 /**< Current pool size (written under lock) */
+        OBJECT_POOL_ATOMIC(size_t) available;                 /**< Number of free objects */
+        ObjectPoolChunk chunks[OBJECT_POOL_MAX_CHUNKS];       /**< Slabs backing the pool, ordered by first_index */
+        OBJECT_POOL_ATOMIC(size_t) chunk_count;               /**< Number of published chunks */
+        pthread_mutex_t lock;                                 /**< Mutex for thread safety */
+        size_t thread_cache_size;                             /**< Per-thread cache capacity (0 if disabled) */
+        pthread_key_t thread_cache_key;                       /**< Key holding the calling thread's cache */
+        struct ObjectPoolThreadCache *thread_caches;          /**< Registered thread caches (guarded by lock) */
+        ObjectPoolMode mode;                                  /**< Synchronization strategy */
+        OBJECT_POOL_ATOMIC(uint64_t) free_head;               /**< Tagged stack head: ABA tag << 32 | slot index (lock-free mode) */
+        ObjectPoolGrowth growth;                              /**< Growth policy on exhaustion */
+        size_t growth_step;                                   /**< Objects added per linear growth */
+        size_t max_size;                                      /**< Upper bound on the pool size (0 for no bound) */
+        unsigned idle_shrink_ms;                              /**< Idle time before a grown chunk is freed (0 disables) */
+        uint64_t last_shrink_check_ms;                        /**< Time of the last idle-chunk scan */
+        ObjectPoolStatStripe stats[OBJECT_POOL_STAT_STRIPES]; /**< Striped statistics counters */
+        OBJECT_POOL_ATOMIC(size_t) high_water_mark;           /**< Most objects outside the shared free list at once */
+        OBJECT_POOL_ATOMIC(uint64_t) corruptions;             /**< Errors caught by the OBJECT_POOL_DEBUG checks */
+        uint64_t resize_count;                                /**< Resizes and growth events (guarded by lock) */
+        uint64_t shrink_count;                                /**< Chunks freed by shrinking or compaction (guarded by lock) */
+        uint64_t relocation_count;                            /**< Objects moved by compaction (guarded by lock) */
+        object_constructor constructor;                       /**< Lazy constructor hook (NULL if unset) */
+        object_callback destructor;                           /**< Destructor hook (NULL if unset) */
+        object_callback reset;                                /**< Reset-on-release hook (NULL if unset) */
+        void *hook_data;                                      /**< User data for the lifecycle hooks */
+        pthread_mutex_t wait_lock;                            /**< Guards the waiter queue; taken before lock, never after it */
+        OBJECT_POOL_ATOMIC(size_t) waiter_count;              /**< Number of queued waiters */
+        struct ObjectPoolWaiter *wait_head;                   /**< Oldest blocked acquirer (guarded by wait_lock) */
+        struct ObjectPoolWaiter *wait_tail;                   /**< Newest blocked acquirer (guarded by wait_lock) */
+        bool wait_fifo;                                       /**< Serve waiters in arrival order with direct handoff */
+        bool handles;                                         /**< Slot generations are tracked for ObjectPoolHandle */
+        size_t active_snapshots;                              /**< Snapshot iterations in progress; chunks are not freed meanwhile (guarded by lock) */
+        OBJECT_POOL_ATOMIC(uint64_t) epoch;                   /**< Global reclamation epoch */
+        pthread_mutex_t retire_lock;                          /**< Guards the retired list and reader registry; taken before lock */
+        pthread_key_t epoch_key;                              /**< Key holding the calling thread's reader record */
+        OBJECT_POOL_ATOMIC(bool) epoch_key_ready;             /**< epoch_key has been created */
+        struct ObjectPoolEpochRecord *epoch_records;          /**< Registered reader records (guarded by retire_lock) */
+        void **retired;                                       /**< Retired objects awaiting their grace period, oldest first */
+        uint64_t *retired_epochs;                             /**< Epoch each retired object was retired in */
+        size_t retired_count;                                 /**< Number of retired objects */
+        size_t retired_capacity;                              /**< Capacity of retired and retired_epochs */
     } ObjectPool;
 
-    // Callback function type for iterating over acquired objects
-    typedef void (*object_callback)(void *object, void *user_data);
-
     /**
      * @brief Initialize the object pool with a dynamic memory block.
      *
@@ -53,6 +256,59 @@ extern "C"
      */
     bool object_pool_init(ObjectPool **pool, size_t initial_size, size_t object_size);
 
+    /**
+     * @brief Initialize the object pool from a configuration structure.
+     *
+     * When config->thread_cache_size is non-zero, every thread keeps a small
+     * private stack of free slots that is refilled from and spilled to the
+     * shared free list in batches of half its capacity, so most acquires and
+     * releases take no lock.
+     *
+     * With config->mode set to OBJECT_POOL_MODE_LOCK_FREE, free slots are kept
+     * on a Treiber stack of slot indices whose head carries a 32-bit ABA tag,
+     * so acquire and release never block. The links live in a per-slot index
+     * array rather than inside the objects, leaving free objects untouched.
+     *
+     * With config->growth set, an acquire that finds the pool empty grows it
+     * by growth_step objects or by doubling it, up to max_size. With
+     * config->idle_shrink_ms set, chunks added by growth are freed once they
+     * have been completely unused for that long; idle shrinking is only
+     * available in mutex mode without thread caches.
+     *
+     * In every mode, acquired slots are tracked in a per-chunk bitmap indexed
+     * by slot, so releases are validated without heap allocation.
+     *
+     * config->alignment pads every object to a multiple of the alignment and
+     * aligns each chunk to it. With an alignment of 64, objects used by
+     * different threads no longer share cache lines. config->huge_pages
+     * backs chunks with mmap on 2 MiB boundaries and advises transparent huge
+     * pages; config->numa_bind prefers config->numa_node for chunk memory and
+     * prefaults it. config->own_pages maps every chunk on its own pages, so a
+     * page number identifies the chunk that holds an object.
+     *
+     * Lifecycle hooks keep expensive inner resources warm across reuse:
+     * config->constructor runs outside the pool lock the first time a slot
+     * is acquired, config->reset runs on every release before the object
+     * returns to the free list, and config->destructor runs once per
+     * constructed object when its chunk is freed by shrinking (under the pool
+     * lock) or by object_pool_destroy. Hooks must not call back into the pool.
+     *
+     * When the library is built with OBJECT_POOL_DEBUG, every slot is
+     * followed by a red zone of guard bytes checked on acquire and release,
+     * free objects are filled with a poison pattern checked when they are
+     * handed out again (skipped for pools with lifecycle hooks, whose objects
+     * keep their state), and releasing an object that is not acquired is
+     * reported as a double release. Each error is logged and counted in
+     * ObjectPoolStats.corruptions. Under AddressSanitizer, free objects and
+     * red zones are also marked unaddressable, so stray accesses are caught
+     * where they happen.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param config Pool configuration.
+     * @return true on success, false on failure.
+     */
+    bool object_pool_init_ex(ObjectPool **pool, const ObjectPoolConfig *config);
+
     /**
      * @brief Acquire an object from the pool.
      *
@@ -61,6 +317,31 @@ extern "C"
      */
     void *object_pool_acquire(ObjectPool *pool);
 
+    /**
+     * @brief Acquire an object, blocking until one is released if the pool is empty.
+     *
+     * The caller is parked on a condition variable instead of spinning.
+     * Every released object wakes at most one waiter, so releases never
+     * cause a thundering herd. With config->wait_fifo, waiters are served
+     * strictly in arrival order: the releasing thread takes a free object
+     * on behalf of the oldest waiter and hands it over directly. With thread
+     * caches enabled, only objects that reach the shared free list (cache
+     * spills, flushes and thread exit) wake waiters.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @return Pointer to the acquired object, or NULL on invalid arguments.
+     */
+    void *object_pool_acquire_wait(ObjectPool *pool);
+
+    /**
+     * @brief Acquire an object, blocking for at most timeout_ms if the pool is empty.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param timeout_ms Longest time to wait, in milliseconds.
+     * @return Pointer to the acquired object, or NULL if the timeout expired.
+     */
+    void *object_pool_acquire_timed(ObjectPool *pool, unsigned timeout_ms);
+
     /**
      * @brief Release an object back to the pool.
      *
@@ -69,18 +350,236 @@ extern "C"
      */
     void object_pool_release(ObjectPool *pool, void *object);
 
+    /**
+     * @brief Enter a read section in which retired objects stay valid.
+     *
+     * Readers that load pointers to pooled objects published by other
+     * threads bracket their accesses with object_pool_read_lock and
+     * object_pool_read_unlock. Entering a section is one store and a fence
+     * on a per-thread record; sections may nest.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @return true on success, false if the reader could not be registered.
+     */
+    bool object_pool_read_lock(ObjectPool *pool);
+
+    /**
+     * @brief Leave a read section entered with object_pool_read_lock.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     */
+    void object_pool_read_unlock(ObjectPool *pool);
+
+    /**
+     * @brief Release an object once every reader that might still see it has moved on.
+     *
+     * The caller first unpublishes the object so no new reader can find it.
+     * The object stays acquired until a grace period has passed, meaning every
+     * read section that was active at retirement has ended, and is then
+     * released as if by object_pool_release. Reclamation is attempted every
+     * OBJECT_POOL_RETIRE_BATCH retirements.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param object Pointer to the object to retire.
+     * @return true on success, false if the retired list could not grow.
+     */
+    bool object_pool_retire(ObjectPool *pool, void *object);
+
+    /**
+     * @brief Release every retired object whose grace period has passed.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @return Number of objects released.
+     */
+    size_t object_pool_reclaim(ObjectPool *pool);
+
+    /**
+     * @brief Wait for a grace period and release every object retired before the call.
+     *
+     * Must not be called from inside a read section.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     */
+    void object_pool_synchronize(ObjectPool *pool);
+
+    /**
+     * @brief Acquire up to count objects with a single synchronization round-trip.
+     *
+     * Mutex-mode pools take the lock once for the whole batch and lock-free
+     * pools detach the batch from the free stack with a single CAS. The
+     * batch may be only partly filled if the pool runs out.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param objects Array receiving the acquired objects.
+     * @param count Number of objects requested.
+     * @return Number of objects stored in objects.
+     */
+    size_t object_pool_acquire_n(ObjectPool *pool, void **objects, size_t count);
+
+    /**
+     * @brief Release count objects with a single synchronization round-trip.
+     *
+     * NULL entries and objects not acquired from the pool are skipped.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param objects Array of objects to release.
+     * @param count Number of entries in objects.
+     * @return Number of objects returned to the pool.
+     */
+    size_t object_pool_release_n(ObjectPool *pool, void *const *objects, size_t count);
+
+    /**
+     * @brief Get the pool-wide index of an object's slot.
+     *
+     * Slot indices are dense, start at 0 and never change for the lifetime
+     * of the pool, so they can stand in for pointers in compact structures
+     * such as the queue in pool_queue.h.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param object Pointer to an object of the pool.
+     * @return The slot index, or OBJECT_POOL_INVALID_INDEX if object is not a slot of the pool.
+     */
+    size_t object_pool_index_of(ObjectPool *pool, const void *object);
+
+    /**
+     * @brief Acquire an object and return a handle to it instead of a pointer.
+     *
+     * A handle packs the slot index with the slot's generation, which is
+     * bumped on every release, into 32 bits. Handles are half the size of a
+     * pointer and a stale one, kept after its object was released, no
+     * longer resolves even once the slot is reused. Requires
+     * config->handles, and slots below 2^OBJECT_POOL_HANDLE_INDEX_BITS;
+     * generations wrap after 2^(32 - OBJECT_POOL_HANDLE_INDEX_BITS) - 1
+     * reuses of a slot.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @return Handle to the acquired object, or OBJECT_POOL_NULL_HANDLE on failure.
+     */
+    ObjectPoolHandle object_pool_acquire_handle(ObjectPool *pool);
+
+    /**
+     * @brief Get the handle of an acquired object.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param object Acquired object of the pool.
+     * @return Its handle, or OBJECT_POOL_NULL_HANDLE if object is not acquired or has no handle.
+     */
+    ObjectPoolHandle object_pool_handle_of(ObjectPool *pool, const void *object);
+
+    /**
+     * @brief Turn a handle back into a pointer in O(1).
+     *
+     * The result is only meaningful while the caller keeps the object from
+     * being released, e.g. by owning the handle or inside a read section.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param handle Handle from object_pool_acquire_handle or object_pool_handle_of.
+     * @return Pointer to the object, or NULL if the handle is null or stale.
+     */
+    void *object_pool_resolve(ObjectPool *pool, ObjectPoolHandle handle);
+
+    /**
+     * @brief Release the object a handle refers to.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param handle Handle of the object.
+     * @return true on success, false if the handle is null or stale.
+     */
+    bool object_pool_release_handle(ObjectPool *pool, ObjectPoolHandle handle);
+
+    /**
+     * @brief Get the object stored in a slot.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param index Slot index from object_pool_index_of.
+     * @return Pointer to the object, or NULL if index is out of range or its chunk was freed by shrinking.
+     */
+    void *object_pool_at(ObjectPool *pool, size_t index);
+
     /**
      * @brief Resize the pool to add more objects.
      *
+     * Growth allocates one new chunk for the additional objects and never
+     * moves existing ones, so it is safe while other threads hold or are
+     * acquiring objects. A pool can grow at most OBJECT_POOL_MAX_CHUNKS - 1
+     * times.
+     *
      * @param pool Pointer to the ObjectPool structure.
      * @param new_size The new size of the pool.
      * @return true on success, false on failure.
      */
     bool object_pool_resize(ObjectPool *pool, size_t new_size);
 
+    /**
+     * @brief Return the calling thread's cached objects to the shared pool.
+     *
+     * Called automatically when a thread exits and for every thread by
+     * object_pool_destroy(). Does nothing if thread caching is disabled.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     */
+    void object_pool_thread_cache_flush(ObjectPool *pool);
+
+    /**
+     * @brief Free every grown chunk that is currently completely unused.
+     *
+     * The chunk from object_pool_init is always kept. Only available in
+     * mutex mode without thread caches.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @return Number of objects removed from the pool.
+     */
+    size_t object_pool_shrink(ObjectPool *pool);
+
+    /**
+     * @brief Move live objects out of sparse grown chunks and free the chunks.
+     *
+     * Each step picks the grown chunk with the fewest acquired objects
+     * whose objects fit in the free slots of the other chunks, copies up
+     * to OBJECT_POOL_COMPACT_BATCH of them into those slots, calling
+     * relocate for each, and frees the chunk once it is empty. The pool
+     * lock is dropped between steps, so acquirers wait for at most one
+     * batch, and the call returns once budget_us has elapsed. Work done
+     * is kept, so calling again continues where the last call stopped.
+     *
+     * relocate runs under the pool lock and must only repoint the
+     * caller's references; it may call object_pool_index_of or
+     * object_pool_handle_of on the new object, but nothing that locks the
+     * pool. No other thread may touch a moved object during the call.
+     * Handles to a moved object go stale. The chunk from object_pool_init
+     * is never freed. Nothing is moved while retired objects await
+     * reclamation or a snapshot iteration is running. Only available in
+     * mutex mode without thread caches.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param relocate Callback told about every move.
+     * @param user_data User data to be passed to relocate.
+     * @param budget_us Time budget in microseconds (0 runs until no chunk can be freed).
+     * @return Number of objects moved; 0 once there is nothing left to compact.
+     */
+    size_t object_pool_compact(ObjectPool *pool, object_relocate relocate, void *user_data, unsigned budget_us);
+
+    /**
+     * @brief Take a snapshot of the pool's cumulative statistics.
+     *
+     * Counters are kept in per-thread stripes with relaxed atomics and stay
+     * enabled at all times. One in OBJECT_POOL_LATENCY_SAMPLE_INTERVAL
+     * acquires per thread is timed for the latency histogram. Lock waits are
+     * only timed when a trylock fails. The snapshot is exact when the pool is
+     * quiescent and approximate while other threads are using it.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param stats Receives the snapshot.
+     * @return true on success, false on invalid arguments.
+     */
+    bool object_pool_get_stats(ObjectPool *pool, ObjectPoolStats *stats);
+
     /**
      * @brief Destroy the object pool and free its memory.
      *
+     * This includes the ObjectPool structure allocated by object_pool_init,
+     * so pool must not be used or freed afterwards.
+     *
      * @param pool Pointer to the ObjectPool structure.
      */
     void object_pool_destroy(ObjectPool *pool);
@@ -88,12 +587,106 @@ extern "C"
     /**
      * @brief Iterate over all acquired objects in the pool.
      *
+     * In mutex mode without thread caches the pool lock is held for the
+     * whole walk, including the callbacks; see object_pool_iterate_snapshot
+     * for a variant that does not stall other threads.
+     *
      * @param pool Pointer to the ObjectPool structure.
      * @param callback Callback function to be called for each object.
      * @param user_data User data to be passed to the callback function.
      */
     void object_pool_iterate_acquired(ObjectPool *pool, object_callback callback, void *user_data);
 
+    /**
+     * @brief Iterate over a snapshot of the acquired objects with the callbacks outside the lock.
+     *
+     * The acquired bitmaps are copied under the pool lock, which is then
+     * released before any callback runs, so acquires and releases proceed
+     * while the snapshot is walked. Every object acquired when the snapshot
+     * was taken is visited once, even if it has been released since; its
+     * memory stays valid because idle shrinking is suspended until the walk
+     * completes. In lock-free and thread-cache modes each bitmap word is
+     * copied atomically but the words are not captured at a single instant.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param callback Callback function to be called for each object.
+     * @param user_data User data to be passed to the callback function.
+     * @return Number of objects visited.
+     */
+    size_t object_pool_iterate_snapshot(ObjectPool *pool, object_callback callback, void *user_data);
+
+    /**
+     * @brief Like object_pool_iterate_snapshot, but splits the snapshot across threads.
+     *
+     * The bitmap is divided into contiguous ranges of at least 64 slots,
+     * one per thread, with the calling thread taking the first range. The
+     * callback must be safe to call concurrently.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param callback Callback function to be called for each object.
+     * @param user_data User data to be passed to the callback function.
+     * @param thread_count Number of threads to use (0 selects the number of online CPUs).
+     * @return Number of objects visited.
+     */
+    size_t object_pool_iterate_parallel(ObjectPool *pool, object_callback callback, void *user_data,
+                                        size_t thread_count);
+
+    /**
+     * @brief Count the acquired objects that satisfy a predicate.
+     *
+     * Walks the acquired bitmaps like object_pool_iterate_acquired, with the
+     * same locking, and skips runs of empty bitmap words with the SIMD scan
+     * kernel reported by object_pool_simd_kernel.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param predicate Function returning true for objects to count.
+     * @param user_data User data to be passed to the predicate.
+     * @return Number of acquired objects for which predicate returned true.
+     */
+    size_t object_pool_count_if(ObjectPool *pool, object_predicate predicate, void *user_data);
+
+    /**
+     * @brief Find the first slot at or after an index that is not acquired.
+     *
+     * Full bitmap words are skipped several at a time by the SIMD scan
+     * kernel. Slots held in thread caches count as free. The pool is not
+     * locked, so the answer may be stale by the time it is returned.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param from Slot index to start from.
+     * @return Index of the first free slot, or OBJECT_POOL_INVALID_INDEX if there is none.
+     */
+    size_t object_pool_find_free(ObjectPool *pool, size_t from);
+
+    /**
+     * @brief Fill every free slot in a range of slot indices with a byte value.
+     *
+     * Consecutive free slots are filled with a single memset, so zeroing a
+     * mostly free range ahead of time is a few large stores instead of one
+     * memset per acquire. In mutex mode without thread caches the pool lock
+     * is held; in the other modes the caller must keep other threads from
+     * acquiring slots in the range meanwhile. Pools with constructor or
+     * destructor hooks are refused, since their free slots hold live
+     * objects, as are debug builds that poison free slots.
+     *
+     * @param pool Pointer to the ObjectPool structure.
+     * @param first First slot index of the range.
+     * @param count Number of slot indices in the range (SIZE_MAX for the rest of the pool).
+     * @param value Byte value to store, as for memset.
+     * @return Number of slots filled.
+     */
+    size_t object_pool_fill_free(ObjectPool *pool, size_t first, size_t count, int value);
+
+    /**
+     * @brief Get the name of the bitmap scan kernel chosen for this CPU.
+     *
+     * The kernel is picked on first use with CPUID: "avx2", "sse4.1", or
+     * "scalar" on other CPUs and when built with OBJECT_POOL_NO_SIMD.
+     *
+     * @return Static string naming the kernel.
+     */
+    const char *object_pool_simd_kernel(void);
+
 #ifdef __cplusplus
 }
 #endif
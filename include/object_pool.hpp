@@ -0,0 +1,367 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "object_pool.h"
+
+/**
+ * @file object_pool.hpp
+ * @brief Header-only, type-safe C++ interface to the object pool.
+ *
+ * object_pool::ObjectPool<T, N> sizes and aligns the underlying C pool for T
+ * at compile time and hands out RAII handles that return their object to the
+ * pool when they go out of scope, including during stack unwinding. Requires
+ * C++17.
+ */
+
+namespace object_pool
+{
+    template <typename T, std::size_t N>
+    class ObjectPool;
+
+    /**
+     * @class PoolDeleter
+     * @brief unique_ptr deleter that destroys an object and releases its slot.
+     */
+    template <typename T, std::size_t N>
+    class PoolDeleter
+    {
+    public:
+        PoolDeleter() noexcept = default;
+
+        explicit PoolDeleter(ObjectPool<T, N> *pool) noexcept : pool_(pool) {}
+
+        void operator()(T *object) const noexcept
+        {
+            pool_->destroy(object);
+        }
+
+    private:
+        ObjectPool<T, N> *pool_ = nullptr; /**< Pool the object is returned to */
+    };
+
+    /**
+     * @class ObjectPool
+     * @brief Fixed-capacity pool of N objects of type T.
+     *
+     * With ObjectPoolConfig::thread_cache_size set, every thread keeps a
+     * cache of up to that many slots (at most max_cache_size) in a
+     * thread_local of this class, in place of the C pool's own thread cache.
+     * A cache hit on emplace or destroy is a few inline instructions
+     * specialized for T, with no call into the C library. Caches refill from
+     * and spill to the C pool in batches of half their capacity, so the C
+     * statistics count slots entering and leaving the caches. A release
+     * bypasses the cache while threads are blocked in emplace_wait or
+     * emplace_for. As with the C thread caches, slots parked in one thread's
+     * cache are not available to other threads until it spills, the thread
+     * exits or the pool is destroyed. Without a cache, every acquire and
+     * release is a call into the C library.
+     *
+     * Objects are constructed with placement new on every emplace and
+     * destroyed before their slot is released, so the C lifecycle hooks are
+     * not used. The pool must outlive every handle it has issued.
+     */
+    template <typename T, std::size_t N>
+    class ObjectPool
+    {
+        static_assert(N > 0, "ObjectPool capacity must be non-zero");
+        static_assert(!std::is_array<T>::value && !std::is_reference<T>::value,
+                      "ObjectPool element type must be an object type");
+        static_assert(alignof(T) <= OBJECT_POOL_MAX_ALIGNMENT, "alignof(T) exceeds OBJECT_POOL_MAX_ALIGNMENT");
+
+    public:
+        using value_type = T;
+        using deleter_type = PoolDeleter<T, N>;
+        using handle = std::unique_ptr<T, deleter_type>;
+
+        static constexpr std::size_t capacity = N;                  /**< Number of objects in the pool */
+        static constexpr std::size_t object_size = sizeof(T);       /**< Size of each slot's object */
+        static constexpr std::size_t object_alignment = alignof(T); /**< Alignment every slot honours */
+        static constexpr std::size_t max_cache_size = 64;           /**< Largest per-thread cache */
+
+        /**
+         * @brief Create the pool.
+         *
+         * The size, capacity and alignment fields of config are overridden
+         * from T and N, growth is disabled and the lifecycle hooks are
+         * cleared; thread_cache_size sizes this wrapper's inline cache; the
+         * remaining options (mode, huge pages, NUMA, wait_fifo, a larger
+         * alignment) are passed through.
+         *
+         * @param config Options for the underlying C pool.
+         * @throw std::bad_alloc if the pool cannot be initialized.
+         */
+        explicit ObjectPool(ObjectPoolConfig config = ObjectPoolConfig())
+        {
+            config.initial_size = N;
+            config.object_size = sizeof(T);
+            config.growth = OBJECT_POOL_GROWTH_NONE;
+            config.max_size = N;
+            config.idle_shrink_ms = 0;
+            config.constructor = nullptr;
+            config.destructor = nullptr;
+            config.reset = nullptr;
+            config.hook_data = nullptr;
+            if (alignof(T) > alignof(std::max_align_t) && config.alignment < alignof(T))
+            {
+                config.alignment = alignof(T);
+            }
+            cache_size_ = config.thread_cache_size < max_cache_size ? config.thread_cache_size : max_cache_size;
+            config.thread_cache_size = 0;
+
+            if (cache_size_ > 0)
+            {
+                registry_ = std::make_shared<Registry>();
+            }
+            if (!object_pool_init_ex(&pool_, &config))
+            {
+                throw std::bad_alloc();
+            }
+            if (registry_)
+            {
+                registry_->pool = pool_;
+            }
+        }
+
+        ~ObjectPool()
+        {
+            if (!registry_)
+            {
+                object_pool_destroy(pool_);
+                return;
+            }
+
+            // No handle is left, so every acquired slot sits in some thread's cache; return them all
+            // and leave the caches of other threads to notice the pool is gone when they next flush
+            std::lock_guard<std::mutex> guard(registry_->lock);
+            if (cache_.registry == registry_)
+            {
+                cache_.count = 0;
+            }
+            for (std::size_t index = 0; index < N;)
+            {
+                std::size_t free_index = object_pool_find_free(pool_, index);
+                std::size_t end = free_index == OBJECT_POOL_INVALID_INDEX ? N : free_index;
+                for (; index < end; index++)
+                {
+                    object_pool_release(pool_, object_pool_at(pool_, index));
+                }
+                index = end + 1;
+            }
+            object_pool_destroy(pool_);
+            registry_->pool = nullptr;
+        }
+
+        ObjectPool(const ObjectPool &) = delete;
+        ObjectPool &operator=(const ObjectPool &) = delete;
+
+        /**
+         * @brief Construct a T in a free slot from args.
+         *
+         * If T's constructor throws, the slot is released and the exception
+         * propagates.
+         *
+         * @return Handle owning the object, or an empty handle if the pool is exhausted.
+         */
+        template <typename... Args>
+        handle emplace(Args &&...args)
+        {
+            return construct(acquire_slot(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Like emplace(), but blocks until a slot is released if the pool is exhausted.
+         */
+        template <typename... Args>
+        handle emplace_wait(Args &&...args)
+        {
+            void *slot = acquire_slot();
+            return construct(slot ? slot : object_pool_acquire_wait(pool_), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Like emplace(), but blocks for at most timeout_ms if the pool is exhausted.
+         *
+         * @return Handle owning the object, or an empty handle if the timeout expired.
+         */
+        template <typename... Args>
+        handle emplace_for(unsigned timeout_ms, Args &&...args)
+        {
+            void *slot = acquire_slot();
+            return construct(slot ? slot : object_pool_acquire_timed(pool_, timeout_ms), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Destroy an object obtained from this pool and release its slot.
+         *
+         * Called by the handle's deleter; only needed for objects detached
+         * from their handle with release().
+         */
+        void destroy(T *object) noexcept
+        {
+            if (object == nullptr)
+            {
+                return;
+            }
+            if constexpr (!std::is_trivially_destructible<T>::value)
+            {
+                object->~T();
+            }
+            release_slot(object);
+        }
+
+        /**
+         * @brief Number of free slots outside the thread caches; approximate while other threads use the pool.
+         */
+        std::size_t available() const noexcept
+        {
+            return pool_->available.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief The underlying C pool, e.g. for object_pool_get_stats().
+         */
+        ::ObjectPool *native() const noexcept
+        {
+            return pool_;
+        }
+
+    private:
+        // Lets thread caches reach the C pool only while it is alive
+        struct Registry
+        {
+            std::mutex lock;              /**< Serializes cache flushes against pool destruction */
+            ::ObjectPool *pool = nullptr; /**< Underlying C pool, or nullptr once destroyed */
+        };
+
+        // Slots the calling thread holds for one pool, still acquired as far as the C pool knows
+        struct Cache
+        {
+            std::shared_ptr<Registry> registry; /**< Registry of the pool the slots belong to */
+            std::size_t count = 0;              /**< Number of cached slots */
+            void *slots[max_cache_size];        /**< Cached slots, most recently released last */
+
+            ~Cache()
+            {
+                flush();
+            }
+
+            // Helper function to hand every cached slot back to its pool, if it still exists
+            void flush() noexcept
+            {
+                if (registry && count > 0)
+                {
+                    std::lock_guard<std::mutex> guard(registry->lock);
+                    if (registry->pool)
+                    {
+                        object_pool_release_n(registry->pool, slots, count);
+                    }
+                }
+                count = 0;
+            }
+        };
+
+        // Fast path: pops the calling thread's cache, going to the C pool only when it is empty
+        void *acquire_slot() noexcept
+        {
+            Cache &cache = cache_;
+            if (cache.registry == registry_ && cache.count > 0)
+            {
+                return cache.slots[--cache.count];
+            }
+            return refill();
+        }
+
+        // Fast path: pushes onto the calling thread's cache unless it is full or someone is waiting
+        void release_slot(void *slot) noexcept
+        {
+            Cache &cache = cache_;
+            if (cache.registry == registry_ && cache.count < cache_size_ &&
+                pool_->waiter_count.load(std::memory_order_relaxed) == 0)
+            {
+                cache.slots[cache.count++] = slot;
+                return;
+            }
+            spill(slot);
+        }
+
+        // Helper function to point the calling thread's cache at this pool, flushing slots of another
+        void bind(Cache &cache) noexcept
+        {
+            if (cache.registry != registry_)
+            {
+                cache.flush();
+                cache.registry = registry_;
+            }
+        }
+
+        // Helper function to refill the calling thread's cache with half its capacity and take one slot
+        void *refill() noexcept
+        {
+            if (cache_size_ == 0)
+            {
+                return object_pool_acquire(pool_);
+            }
+
+            Cache &cache = cache_;
+            bind(cache);
+            cache.count = object_pool_acquire_n(pool_, cache.slots, (cache_size_ + 1) / 2);
+            return cache.count > 0 ? cache.slots[--cache.count] : nullptr;
+        }
+
+        // Helper function to release a slot the fast path could not cache, spilling half a full cache
+        void spill(void *slot) noexcept
+        {
+            if (cache_size_ == 0 || pool_->waiter_count.load(std::memory_order_relaxed) > 0)
+            {
+                object_pool_release(pool_, slot);
+                return;
+            }
+
+            Cache &cache = cache_;
+            bind(cache);
+            if (cache.count == cache_size_)
+            {
+                std::size_t batch = (cache_size_ + 1) / 2;
+                cache.count -= batch;
+                object_pool_release_n(pool_, cache.slots + cache.count, batch);
+            }
+            cache.slots[cache.count++] = slot;
+        }
+
+        // Helper function to construct a T in an acquired slot
+        template <typename... Args>
+        handle construct(void *slot, Args &&...args)
+        {
+            if (slot == nullptr)
+            {
+                return handle(nullptr, deleter_type(this));
+            }
+
+            T *object;
+            try
+            {
+                object = ::new (slot) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                release_slot(slot);
+                throw;
+            }
+            return handle(object, deleter_type(this));
+        }
+
+        inline static thread_local Cache cache_; /**< Calling thread's cache for pools of this type */
+        ::ObjectPool *pool_ = nullptr;           /**< Underlying C pool */
+        std::size_t cache_size_ = 0;             /**< Per-thread cache capacity (0 disables the cache) */
+        std::shared_ptr<Registry> registry_;     /**< Shared with the caches holding this pool's slots */
+    };
+} // namespace object_pool
+
+#endif // OBJECT_POOL_HPP
@@ -4,5 +4,10 @@
 // Include the necessary headers for the library
 #include "cli_logger.h"
 #include "object_pool.h"
+#include "size_class_pool.h"
+#include "sharded_pool.h"
+#include "shm_pool.h"
+#include "pool_queue.h"
+#include "soa_pool.h"
 
 #endif // OBJECT_POOL_LIBRARY_H
@@ -0,0 +1,111 @@
+#ifndef POOL_QUEUE_H
+#define POOL_QUEUE_H
+
+#include <stddef.h>
+#include "object_pool.h"
+
+#ifndef __cplusplus
+#include <stdalign.h>
+#endif
+
+/**
+ * @file pool_queue.h
+ * @brief Bounded lock-free MPMC queue passing pool objects between threads by slot index.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define POOL_QUEUE_CACHE_LINE 64 /**< Alignment keeping the producer and consumer positions apart */
+
+    // One ring cell: a sequence number and the slot index it carries, defined in pool_queue.c
+    struct PoolQueueCell;
+
+    /**
+     * @struct PoolQueue
+     * @brief Fixed-capacity ring of slot indices of one ObjectPool.
+     *
+     * A Vyukov bounded queue: every cell carries a sequence number telling
+     * producers and consumers whose turn it is, so enqueue and dequeue each
+     * claim a position with one CAS and never block or allocate. Producers
+     * acquire an object, fill it and enqueue its slot index; consumers
+     * dequeue the index, process the object and release it. Objects stay
+     * acquired while queued, and the queue itself never touches them.
+     */
+    typedef struct PoolQueue
+    {
+        ObjectPool *pool;                                                      /**< Pool the queued slot indices belong to */
+        struct PoolQueueCell *cells;                                           /**< Ring of capacity cells */
+        size_t capacity;                                                       /**< Number of cells, a power of two */
+        size_t mask;                                                           /**< capacity - 1 */
+        alignas(POOL_QUEUE_CACHE_LINE) OBJECT_POOL_ATOMIC(size_t) enqueue_pos; /**< Next position producers claim */
+        alignas(POOL_QUEUE_CACHE_LINE) OBJECT_POOL_ATOMIC(size_t) dequeue_pos; /**< Next position consumers claim */
+    } PoolQueue;
+
+    /**
+     * @brief Create a queue for objects of a pool.
+     *
+     * @param queue Receives the queue.
+     * @param pool Pool whose objects are passed through the queue.
+     * @param capacity Number of entries, rounded up to a power of two (at least 2).
+     * @return true on success, false on failure.
+     */
+    bool pool_queue_init(PoolQueue **queue, ObjectPool *pool, size_t capacity);
+
+    /**
+     * @brief Append a slot index.
+     *
+     * @param queue Pointer to the PoolQueue structure.
+     * @param index Slot index of an acquired object, from object_pool_index_of.
+     * @return true on success, false if the queue is full.
+     */
+    bool pool_queue_enqueue(PoolQueue *queue, size_t index);
+
+    /**
+     * @brief Take the oldest slot index.
+     *
+     * @param queue Pointer to the PoolQueue structure.
+     * @param index Receives the slot index.
+     * @return true on success, false if the queue is empty.
+     */
+    bool pool_queue_dequeue(PoolQueue *queue, size_t *index);
+
+    /**
+     * @brief Append an acquired object, converting it to its slot index.
+     *
+     * @param queue Pointer to the PoolQueue structure.
+     * @param object Acquired object of the queue's pool.
+     * @return true on success, false if the queue is full or object is not a slot of the pool.
+     */
+    bool pool_queue_push(PoolQueue *queue, void *object);
+
+    /**
+     * @brief Take the oldest object.
+     *
+     * @param queue Pointer to the PoolQueue structure.
+     * @return Pointer to the object, or NULL if the queue is empty.
+     */
+    void *pool_queue_pop(PoolQueue *queue);
+
+    /**
+     * @brief Get the number of queued entries.
+     *
+     * @param queue Pointer to the PoolQueue structure.
+     * @return Number of entries; approximate while the queue is in use.
+     */
+    size_t pool_queue_size(const PoolQueue *queue);
+
+    /**
+     * @brief Release every object still queued to the pool and free the queue.
+     *
+     * @param queue Pointer to the PoolQueue structure.
+     */
+    void pool_queue_destroy(PoolQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POOL_QUEUE_H
@@ -0,0 +1,124 @@
+#ifndef SHARDED_POOL_H
+#define SHARDED_POOL_H
+
+#include <stddef.h>
+#include "object_pool.h"
+
+/**
+ * @file sharded_pool.h
+ * @brief Object pool split into per-CPU shards that steal from each other on exhaustion.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SHARDED_POOL_MAX_SHARDS 1024 /**< Upper bound on the number of shards */
+
+    // Per-shard state, defined in sharded_pool.c
+    struct ShardedPoolShard;
+
+    /**
+     * @struct ShardedPoolConfig
+     * @brief Options for sharded_pool_init(). Zeroed fields select the defaults.
+     */
+    typedef struct ShardedPoolConfig
+    {
+        size_t total_size;        /**< Objects across all shards; each shard gets an equal share */
+        size_t object_size;       /**< Size of each object in bytes */
+        size_t shard_count;       /**< Number of shards (0 selects the number of online CPUs) */
+        size_t steal_batch;       /**< Objects taken from a neighbor per steal (0 selects a quarter of a shard) */
+        size_t thread_cache_size; /**< Per-thread cache capacity of each shard (0 disables caching) */
+        ObjectPoolMode mode;      /**< Synchronization strategy of each shard */
+        size_t alignment;         /**< Per-object alignment, as in ObjectPoolConfig */
+    } ShardedPoolConfig;
+
+    /**
+     * @struct ShardedPool
+     * @brief A fixed set of object pools, one per CPU.
+     *
+     * Acquires go to the shard of the CPU the caller runs on (from
+     * sched_getcpu, or a round-robin thread index where it is unavailable),
+     * so threads on different CPUs never share a lock or a free list. A
+     * shard that runs dry steals up to half of the next non-empty shard's
+     * free objects, at most steal_batch, and keeps the surplus in a small
+     * stash for its following acquires. Releases always return an object to
+     * the shard that owns its memory, so the total number of objects never
+     * changes.
+     */
+    typedef struct ShardedPool
+    {
+        struct ShardedPoolShard *shards;     /**< Cache-line aligned shard array */
+        size_t shard_count;                  /**< Number of shards */
+        size_t object_size;                  /**< Size of each object */
+        size_t steal_batch;                  /**< Objects taken from a neighbor per steal */
+        size_t *by_address;                  /**< Shard indices sorted by memory address, for release lookups */
+        OBJECT_POOL_ATOMIC(uint64_t) steals; /**< Batches stolen from neighboring shards */
+    } ShardedPool;
+
+    /**
+     * @brief Initialize a sharded pool.
+     *
+     * @param pool Receives the sharded pool.
+     * @param config Pool configuration.
+     * @return true on success, false on failure.
+     */
+    bool sharded_pool_init(ShardedPool **pool, const ShardedPoolConfig *config);
+
+    /**
+     * @brief Acquire an object from the calling CPU's shard, stealing if it is empty.
+     *
+     * Objects moving between shards during the search can make an acquire
+     * miss while the pool is nearly exhausted, so NULL is a hint to retry.
+     *
+     * @param pool Pointer to the ShardedPool structure.
+     * @return Pointer to the acquired object, or NULL if no shard had a free object.
+     */
+    void *sharded_pool_acquire(ShardedPool *pool);
+
+    /**
+     * @brief Release an object to the shard that owns it.
+     *
+     * @param pool Pointer to the ShardedPool structure.
+     * @param object Pointer to the object to be released.
+     */
+    void sharded_pool_release(ShardedPool *pool, void *object);
+
+    /**
+     * @brief Count the free objects across all shards, including stolen surplus.
+     *
+     * @param pool Pointer to the ShardedPool structure.
+     * @return Number of objects available; approximate while the pool is in use.
+     */
+    size_t sharded_pool_available(ShardedPool *pool);
+
+    /**
+     * @brief Get the shard serving the calling thread.
+     *
+     * @param pool Pointer to the ShardedPool structure.
+     * @return The shard index.
+     */
+    size_t sharded_pool_current_shard(const ShardedPool *pool);
+
+    /**
+     * @brief Get the object pool backing a shard, e.g. for object_pool_get_stats().
+     *
+     * @param pool Pointer to the ShardedPool structure.
+     * @param index Shard index.
+     * @return The shard's pool, or NULL if index is out of range.
+     */
+    ObjectPool *sharded_pool_shard(ShardedPool *pool, size_t index);
+
+    /**
+     * @brief Destroy every shard and free the sharded pool.
+     *
+     * @param pool Pointer to the ShardedPool structure.
+     */
+    void sharded_pool_destroy(ShardedPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHARDED_POOL_H
@@ -0,0 +1,203 @@
+#ifndef SHM_POOL_H
+#define SHM_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "object_pool.h"
+
+/**
+ * @file shm_pool.h
+ * @brief Fixed-size object pool in shared memory, usable by several processes at once.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SHM_POOL_NULL_OFFSET UINT64_MAX /**< Offset that refers to no object */
+
+    // Segment header shared by all processes, defined in shm_pool.c
+    struct ShmPoolHeader;
+
+    /**
+     * @struct ShmPool
+     * @brief One process's attachment to a shared-memory pool.
+     *
+     * The segment holds the header, free-list links, acquired bitmap and
+     * objects, and refers to slots only by index, so every process can map
+     * it at a different address. Free slots form a lock-free Treiber stack
+     * with an ABA tag, as in OBJECT_POOL_MODE_LOCK_FREE. It takes no locks,
+     * so a process that dies mid-operation cannot leave the pool locked;
+     * at worst the objects it held are not returned.
+     *
+     * Objects are exchanged between processes as offsets from
+     * shm_pool_offset, which shm_pool_pointer turns back into local
+     * pointers.
+     */
+    typedef struct ShmPool
+    {
+        struct ShmPoolHeader *header;                  /**< Start of this process's mapping */
+        size_t mapped_size;                            /**< Length of the mapping */
+        int fd;                                        /**< Descriptor of the shared memory object */
+        OBJECT_POOL_ATOMIC(uint32_t) *free_next;       /**< Per-slot next free index */
+        OBJECT_POOL_ATOMIC(uint64_t) *acquired_bitmap; /**< One bit per slot, set while the slot is acquired */
+        char *slab;                                    /**< First object */
+        size_t capacity;                               /**< Number of objects */
+        size_t object_size;                            /**< Size of each object */
+        size_t stride;                                 /**< Distance between consecutive objects */
+        bool persistent;                               /**< Opened with shm_pool_open_file */
+    } ShmPool;
+
+    /**
+     * @brief Create a pool in a new shared memory segment.
+     *
+     * With a name (e.g. "/records"), a POSIX shared memory object is created
+     * and fails if the name exists; other processes attach with
+     * shm_pool_open. With a NULL name, an anonymous memfd is used instead,
+     * shared with children across fork or with other processes by passing
+     * shm_pool_fd over a Unix socket.
+     *
+     * @param pool Receives the attachment.
+     * @param name Segment name, or NULL for an anonymous memfd.
+     * @param capacity Number of objects.
+     * @param object_size Size of each object in bytes.
+     * @return true on success, false on failure.
+     */
+    bool shm_pool_create(ShmPool **pool, const char *name, size_t capacity, size_t object_size);
+
+    /**
+     * @brief Attach to a pool created by shm_pool_create under a name.
+     *
+     * @param pool Receives the attachment.
+     * @param name Segment name passed to shm_pool_create.
+     * @return true on success, false if the segment is missing or invalid.
+     */
+    bool shm_pool_open(ShmPool **pool, const char *name);
+
+    /**
+     * @brief Attach to a pool through a descriptor of its segment.
+     *
+     * The descriptor is duplicated, so the caller keeps ownership of fd.
+     *
+     * @param pool Receives the attachment.
+     * @param fd Descriptor of the segment, e.g. received over a Unix socket.
+     * @return true on success, false if the segment is invalid.
+     */
+    bool shm_pool_open_fd(ShmPool **pool, int fd);
+
+    /**
+     * @brief Open a pool kept in a regular file, creating the file if it does not exist.
+     *
+     * The slab, free list and acquired bitmap are mapped straight from the
+     * file, so after a restart the pool and the objects acquired before it
+     * are usable immediately, with pages read in lazily on first touch
+     * rather than rebuilt. Acquired objects are found again with
+     * shm_pool_iterate_acquired. The file is locked for the life of the
+     * attachment, so a second open fails until it is closed or its owner
+     * exits. If the previous owner exited without shm_pool_close, the free
+     * list is rebuilt from the acquired bitmap on open.
+     *
+     * The pool is mapped at its previous address when that range is free,
+     * but objects should still refer to each other by shm_pool_offset.
+     *
+     * @param pool Receives the attachment.
+     * @param path Path of the pool file.
+     * @param capacity Number of objects; must match an existing file.
+     * @param object_size Size of each object in bytes; must match an existing file.
+     * @return true on success, false on failure or if the file is locked or holds a different pool.
+     */
+    bool shm_pool_open_file(ShmPool **pool, const char *path, size_t capacity, size_t object_size);
+
+    /**
+     * @brief Acquire an object from the shared pool.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @return Pointer to the object in this process's mapping, or NULL if the pool is empty.
+     */
+    void *shm_pool_acquire(ShmPool *pool);
+
+    /**
+     * @brief Release an object to the shared pool; any attached process may release it.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @param object Pointer to the object in this process's mapping.
+     */
+    void shm_pool_release(ShmPool *pool, void *object);
+
+    /**
+     * @brief Convert an object pointer to a process-independent offset.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @param object Pointer to an object in this process's mapping.
+     * @return The object's offset, or SHM_POOL_NULL_OFFSET if it is not in the pool.
+     */
+    uint64_t shm_pool_offset(const ShmPool *pool, const void *object);
+
+    /**
+     * @brief Convert an offset from shm_pool_offset to a pointer in this process's mapping.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @param offset Offset of an object.
+     * @return Pointer to the object, or NULL if the offset is not an object's offset.
+     */
+    void *shm_pool_pointer(const ShmPool *pool, uint64_t offset);
+
+    /**
+     * @brief Get the number of free objects.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @return Number of objects available; approximate while the pool is in use.
+     */
+    size_t shm_pool_available(const ShmPool *pool);
+
+    /**
+     * @brief Get the descriptor of the segment, e.g. to pass it to another process.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @return The descriptor, owned by the attachment.
+     */
+    int shm_pool_fd(const ShmPool *pool);
+
+    /**
+     * @brief Invoke a callback on every acquired object.
+     *
+     * Objects acquired or released during the walk may or may not be visited.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @param callback Function to call with each acquired object.
+     * @param user_data Passed through to callback.
+     * @return Number of objects visited.
+     */
+    size_t shm_pool_iterate_acquired(ShmPool *pool, object_callback callback, void *user_data);
+
+    /**
+     * @brief Write the pool's modified pages back to its file and wait for completion.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     * @return true on success, false on failure.
+     */
+    bool shm_pool_sync(ShmPool *pool);
+
+    /**
+     * @brief Detach from the pool and free the attachment; the segment itself is kept.
+     *
+     * A file-backed pool is synced and marked as cleanly closed first.
+     *
+     * @param pool Pointer to the ShmPool structure.
+     */
+    void shm_pool_close(ShmPool *pool);
+
+    /**
+     * @brief Remove a named segment; attached processes keep their mappings.
+     *
+     * @param name Segment name passed to shm_pool_create.
+     * @return true on success, false on failure.
+     */
+    bool shm_pool_unlink(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHM_POOL_H
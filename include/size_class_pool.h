@@ -0,0 +1,133 @@
+#ifndef SIZE_CLASS_POOL_H
+#define SIZE_CLASS_POOL_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include "object_pool.h"
+
+/**
+ * @file size_class_pool.h
+ * @brief Malloc-style allocator that routes variable-size requests to per-size-class object pools.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SIZE_CLASS_POOL_MAX_CLASSES 60                 /**< Number of size classes up to 1 MiB */
+#define SIZE_CLASS_POOL_MAX_CLASS_SIZE ((size_t)1 << 20) /**< Largest size a class can serve */
+#define SIZE_CLASS_POOL_PAGE_SHIFT 12                    /**< Granule of the page map (4 KiB) */
+#define SIZE_CLASS_POOL_LEAF_BITS 18                     /**< Page number bits resolved by one page map leaf */
+#define SIZE_CLASS_POOL_ROOT_BITS 18                     /**< Page number bits resolved by the page map root */
+
+    // Pointer type used for the lazily created class pools
+    typedef ObjectPool *ObjectPoolPtr;
+
+    // One page map leaf: an entry per page telling which class or large allocation owns it
+    typedef OBJECT_POOL_ATOMIC(uint64_t) *SizeClassPageLeaf;
+
+    /**
+     * @struct SizeClassPoolConfig
+     * @brief Options for size_class_pool_init(). Zeroed fields select the defaults.
+     */
+    typedef struct SizeClassPoolConfig
+    {
+        size_t max_class_size;    /**< Largest request served from a class pool; larger ones use malloc (0 selects 4096) */
+        size_t objects_per_class; /**< Initial objects in each class pool, which then grows geometrically (0 selects 64) */
+        size_t thread_cache_size; /**< Per-thread cache capacity of each class pool (0 disables caching) */
+        ObjectPoolMode mode;      /**< Synchronization strategy of each class pool */
+    } SizeClassPoolConfig;
+
+    /**
+     * @struct SizeClassPool
+     * @brief A set of object pools, one per size class.
+     *
+     * Classes follow the jemalloc spacing: 16-byte steps up to 128 bytes,
+     * then four classes per doubling (160, 192, 224, 256, 320, ...). No
+     * block carries a header. Class chunks are mapped on their own pages and
+     * requests above max_class_size get page-aligned heap memory, and both
+     * are recorded in a two-level page map when they are added. Free looks up
+     * the page of the pointer there in O(1): class pages name their class,
+     * the first page of a large allocation holds its size, and pointers the
+     * map does not know are rejected without being dereferenced.
+     */
+    typedef struct SizeClassPool
+    {
+        OBJECT_POOL_ATOMIC(ObjectPoolPtr) classes[SIZE_CLASS_POOL_MAX_CLASSES]; /**< Class pools, created on first use */
+        size_t class_count;                                                     /**< Number of classes in use */
+        size_t max_class_size;                                                  /**< Largest size served from a class pool */
+        size_t objects_per_class;                                               /**< Initial objects per class pool */
+        size_t thread_cache_size;                                               /**< Per-thread cache capacity of each class pool */
+        ObjectPoolMode mode;                                                    /**< Synchronization strategy of each class pool */
+        OBJECT_POOL_ATOMIC(size_t) mapped_chunks[SIZE_CLASS_POOL_MAX_CLASSES];  /**< Chunks of each class recorded in the page map */
+        OBJECT_POOL_ATOMIC(SizeClassPageLeaf) *page_map;                        /**< Page map root, indexed by the top page number bits */
+        pthread_mutex_t lock;                                                   /**< Serializes class pool creation and page map updates */
+    } SizeClassPool;
+
+    /**
+     * @brief Initialize a size-class allocator.
+     *
+     * @param pool Receives the allocator.
+     * @param config Options, or NULL for the defaults.
+     * @return true on success, false on failure.
+     */
+    bool size_class_pool_init(SizeClassPool **pool, const SizeClassPoolConfig *config);
+
+    /**
+     * @brief Allocate at least size bytes, aligned to 16 bytes.
+     *
+     * Requests above max_class_size come from the heap, rounded up to whole
+     * 4 KiB pages.
+     *
+     * @param pool Pointer to the SizeClassPool structure.
+     * @param size Requested size in bytes.
+     * @return Pointer to the memory, or NULL on failure.
+     */
+    void *size_class_pool_alloc(SizeClassPool *pool, size_t size);
+
+    /**
+     * @brief Return memory obtained from size_class_pool_alloc.
+     *
+     * @param pool Pointer to the SizeClassPool structure.
+     * @param ptr Pointer to free; NULL is ignored.
+     */
+    void size_class_pool_free(SizeClassPool *pool, void *ptr);
+
+    /**
+     * @brief Get the number of usable bytes behind an allocation.
+     *
+     * @param pool Pointer to the SizeClassPool structure.
+     * @param ptr Pointer returned by size_class_pool_alloc.
+     * @return The size of the allocation's class, or 0 for an invalid pointer.
+     */
+    size_t size_class_pool_usable_size(SizeClassPool *pool, const void *ptr);
+
+    /**
+     * @brief Map a request size to its size class index.
+     *
+     * @param size Requested size in bytes (at most SIZE_CLASS_POOL_MAX_CLASS_SIZE).
+     * @return The class index.
+     */
+    size_t size_class_index(size_t size);
+
+    /**
+     * @brief Get the object size served by a size class.
+     *
+     * @param index Size class index.
+     * @return The class size in bytes.
+     */
+    size_t size_class_size(size_t index);
+
+    /**
+     * @brief Destroy every class pool and free the allocator.
+     *
+     * @param pool Pointer to the SizeClassPool structure.
+     */
+    void size_class_pool_destroy(SizeClassPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIZE_CLASS_POOL_H
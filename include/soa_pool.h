@@ -0,0 +1,130 @@
+#ifndef SOA_POOL_H
+#define SOA_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "object_pool.h"
+
+/**
+ * @file soa_pool.h
+ * @brief Fixed-capacity pool of records stored as structure-of-arrays columns.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SOA_POOL_MAX_FIELDS 32       /**< Upper bound on the number of fields in a schema */
+#define SOA_POOL_COLUMN_ALIGNMENT 64 /**< Alignment of every column */
+
+    struct SoaPool;
+
+    // Callback receiving a run of consecutive live slots [first, first + count)
+    typedef void (*soa_run_callback)(struct SoaPool *pool, size_t first, size_t count, void *user_data);
+
+    /**
+     * @struct SoaPool
+     * @brief Records split into one contiguous column per field.
+     *
+     * Field i of slot n lives at columns[i] + n * field_sizes[i], so a scan
+     * over one field reads only that field's bytes, in order, and compilers
+     * can vectorize the loop. Records are referred to by slot index. Free
+     * slots form a lock-free Treiber stack with an ABA tag, as in
+     * OBJECT_POOL_MODE_LOCK_FREE, and live slots are tracked in a bitmap for
+     * soa_pool_iterate.
+     */
+    typedef struct SoaPool
+    {
+        char *columns[SOA_POOL_MAX_FIELDS];            /**< Start of each field's column */
+        size_t field_sizes[SOA_POOL_MAX_FIELDS];       /**< Size of each field in bytes */
+        size_t field_count;                            /**< Number of fields */
+        size_t capacity;                               /**< Number of slots */
+        char *memory;                                  /**< Single allocation holding every column */
+        OBJECT_POOL_ATOMIC(uint32_t) *free_next;       /**< Per-slot next free index */
+        OBJECT_POOL_ATOMIC(uint64_t) *acquired_bitmap; /**< One bit per slot, set while the slot is acquired */
+        OBJECT_POOL_ATOMIC(uint64_t) free_head;        /**< Tagged stack head: ABA tag << 32 | slot index */
+        OBJECT_POOL_ATOMIC(size_t) available;          /**< Number of free slots */
+    } SoaPool;
+
+    /**
+     * @brief Initialize a pool from a schema of field sizes.
+     *
+     * @param pool Receives the pool.
+     * @param capacity Number of records.
+     * @param field_sizes Size in bytes of each field, e.g. sizeof(double).
+     * @param field_count Number of fields, at most SOA_POOL_MAX_FIELDS.
+     * @return true on success, false on failure.
+     */
+    bool soa_pool_init(SoaPool **pool, size_t capacity, const size_t *field_sizes, size_t field_count);
+
+    /**
+     * @brief Acquire a record.
+     *
+     * @param pool Pointer to the SoaPool structure.
+     * @return The record's slot index, or OBJECT_POOL_INVALID_INDEX if the pool is empty.
+     */
+    size_t soa_pool_acquire(SoaPool *pool);
+
+    /**
+     * @brief Release a record.
+     *
+     * @param pool Pointer to the SoaPool structure.
+     * @param index Slot index from soa_pool_acquire.
+     */
+    void soa_pool_release(SoaPool *pool, size_t index);
+
+    /**
+     * @brief Get the column holding one field of every record.
+     *
+     * @param pool Pointer to the SoaPool structure.
+     * @param field Field number in the schema.
+     * @return Pointer to the column, aligned to SOA_POOL_COLUMN_ALIGNMENT, or NULL if field is out of range.
+     */
+    void *soa_pool_column(SoaPool *pool, size_t field);
+
+    /**
+     * @brief Get one field of one record.
+     *
+     * @param pool Pointer to the SoaPool structure.
+     * @param index Slot index of the record.
+     * @param field Field number in the schema.
+     * @return Pointer to the field, or NULL if index or field is out of range.
+     */
+    void *soa_pool_field(SoaPool *pool, size_t index, size_t field);
+
+    /**
+     * @brief Invoke a callback on every maximal run of consecutive live slots.
+     *
+     * Runs are found 64 slots at a time from the acquired bitmap and are
+     * merged across bitmap words, so a densely used pool is visited in a
+     * few long runs the callback can scan column by column. Slots acquired
+     * or released during the walk may or may not be visited.
+     *
+     * @param pool Pointer to the SoaPool structure.
+     * @param callback Function to call with each run.
+     * @param user_data Passed through to callback.
+     * @return Number of live slots visited.
+     */
+    size_t soa_pool_iterate(SoaPool *pool, soa_run_callback callback, void *user_data);
+
+    /**
+     * @brief Get the number of free records.
+     *
+     * @param pool Pointer to the SoaPool structure.
+     * @return Number of records available; approximate while the pool is in use.
+     */
+    size_t soa_pool_available(const SoaPool *pool);
+
+    /**
+     * @brief Free the pool and all its columns.
+     *
+     * @param pool Pointer to the SoaPool structure.
+     */
+    void soa_pool_destroy(SoaPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOA_POOL_H
@@ -1,47 +1,232 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "cli_logger.h"
 #include <time.h>
 #include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+
+// Stack buffer for synchronous messages; longer ones fall back to the heap
+#define LOG_SYNC_BUFFER_SIZE 256
 
-// Helper function to get current timestamp as a string
-static void get_timestamp(char *buffer, size_t size)
+// One formatted message waiting in the asynchronous ring buffer
+typedef struct
 {
-    time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
-    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", tm_info);
-}
+    _Atomic size_t sequence;               /**< Vyukov slot sequence number */
+    LogLevel level;                        /**< Severity of the message */
+    time_t time;                           /**< Time the message was logged */
+    char message[LOG_ASYNC_MESSAGE_SIZE];  /**< Formatted message text */
+} LogEntry;
 
-// Core logging function
-static void log_message(LogLevel level, const char *format, va_list args)
+// Bounded multi-producer ring drained by a single background thread
+typedef struct
 {
-    char timestamp[20];
-    get_timestamp(timestamp, sizeof(timestamp));
+    LogEntry *entries;                     /**< Ring slots */
+    size_t mask;                           /**< Capacity minus one (capacity is a power of two) */
+    _Atomic size_t enqueue_pos;            /**< Next slot a producer claims */
+    size_t dequeue_pos;                    /**< Next slot the writer thread reads */
+    _Atomic size_t dropped;                /**< Messages discarded because the ring was full */
+    atomic_bool running;                   /**< Cleared to ask the writer thread to exit */
+    pthread_t thread;                      /**< Background writer thread */
+} LogRing;
 
-    const char *level_str;
-    const char *color;
+static _Atomic int log_threshold = LOG_LEVEL_INFO;
+static LogRing *_Atomic log_ring = NULL;
+static _Atomic size_t log_ring_users = 0;
+static pthread_mutex_t log_async_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Helper function to get current timestamp as a string, reformatting at most once per second per thread
+static const char *get_timestamp(time_t now)
+{
+    static _Thread_local time_t cached_time = (time_t)-1;
+    static _Thread_local char cached_buffer[20];
+
+    if (now != cached_time)
+    {
+        struct tm tm_info;
+        localtime_r(&now, &tm_info);
+        strftime(cached_buffer, sizeof(cached_buffer), "%Y-%m-%d %H:%M:%S", &tm_info);
+        cached_time = now;
+    }
+    return cached_buffer;
+}
 
+// Helper function to map a level to its label and color
+static void level_style(LogLevel level, const char **level_str, const char **color)
+{
     switch (level)
     {
     case LOG_LEVEL_INFO:
-        level_str = "INFO";
-        color = COLOR_GREEN;
+        *level_str = "INFO";
+        *color = COLOR_GREEN;
         break;
     case LOG_LEVEL_WARNING:
-        level_str = "WARNING";
-        color = COLOR_YELLOW;
+        *level_str = "WARNING";
+        *color = COLOR_YELLOW;
         break;
     case LOG_LEVEL_ERROR:
-        level_str = "ERROR";
-        color = COLOR_RED;
+        *level_str = "ERROR";
+        *color = COLOR_RED;
         break;
     default:
-        level_str = "UNKNOWN";
-        color = COLOR_RESET;
+        *level_str = "UNKNOWN";
+        *color = COLOR_RESET;
         break;
     }
+}
+
+// Helper function to write one finished line with a single stdio call
+static void write_line(LogLevel level, time_t now, const char *message)
+{
+    const char *level_str;
+    const char *color;
+    level_style(level, &level_str, &color);
+
+    fprintf(stdout, "%s[%s] [%s]: %s%s\n", color, get_timestamp(now), level_str, message, COLOR_RESET);
+}
+
+// Helper function to claim a ring slot and format into it; returns false when the ring is full
+static bool ring_push(LogRing *ring, LogLevel level, const char *format, va_list args)
+{
+    size_t pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    LogEntry *entry;
+
+    for (;;)
+    {
+        entry = &ring->entries[pos & ring->mask];
+        size_t sequence = atomic_load_explicit(&entry->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+        if (diff == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+        }
+    }
 
-    fprintf(stdout, "%s[%s] [%s]: ", color, timestamp, level_str);
-    vfprintf(stdout, format, args);
-    fprintf(stdout, "%s\n", COLOR_RESET);
+    entry->level = level;
+    entry->time = time(NULL);
+    vsnprintf(entry->message, sizeof(entry->message), format, args);
+    atomic_store_explicit(&entry->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+// Helper function to write every published entry; returns the number written
+static size_t ring_drain(LogRing *ring)
+{
+    size_t written = 0;
+
+    for (;;)
+    {
+        LogEntry *entry = &ring->entries[ring->dequeue_pos & ring->mask];
+        size_t sequence = atomic_load_explicit(&entry->sequence, memory_order_acquire);
+
+        if (sequence != ring->dequeue_pos + 1)
+        {
+            break;
+        }
+
+        write_line(entry->level, entry->time, entry->message);
+        atomic_store_explicit(&entry->sequence, ring->dequeue_pos + ring->mask + 1, memory_order_release);
+        ring->dequeue_pos++;
+        written++;
+    }
+
+    size_t dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+    if (dropped > 0)
+    {
+        char message[64];
+        snprintf(message, sizeof(message), "%zu log messages dropped.", dropped);
+        write_line(LOG_LEVEL_WARNING, time(NULL), message);
+    }
+
+    if (written > 0)
+    {
+        fflush(stdout);
+    }
+    return written;
+}
+
+// Background thread that writes queued messages until asked to stop
+static void *log_writer_thread(void *arg)
+{
+    LogRing *ring = arg;
+    const struct timespec idle = {0, 1000000};
+
+    while (atomic_load_explicit(&ring->running, memory_order_acquire))
+    {
+        if (ring_drain(ring) == 0)
+        {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    ring_drain(ring);
+    return NULL;
+}
+
+// Core logging function
+static void log_message(LogLevel level, const char *format, va_list args)
+{
+    if (!log_level_enabled(level))
+    {
+        return;
+    }
+
+    // Only the async path registers as a ring user, so synchronous logging shares no counter
+    if (atomic_load_explicit(&log_ring, memory_order_relaxed))
+    {
+        atomic_fetch_add(&log_ring_users, 1);
+        // Reloaded after registering: a ring seen now stays alive until the count drops
+        LogRing *ring = atomic_load(&log_ring);
+        if (ring && !ring_push(ring, level, format, args))
+        {
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        }
+        atomic_fetch_sub(&log_ring_users, 1);
+        if (ring)
+        {
+            return;
+        }
+    }
+
+    // Synchronous messages are never truncated: the stack buffer covers the usual case and
+    // longer ones are formatted again into a heap buffer of the exact length
+    char buffer[LOG_SYNC_BUFFER_SIZE];
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(buffer, sizeof(buffer), format, copy);
+    va_end(copy);
+
+    char *message = buffer;
+    if (length >= (int)sizeof(buffer))
+    {
+        char *heap = malloc((size_t)length + 1);
+        if (heap)
+        {
+            vsnprintf(heap, (size_t)length + 1, format, args);
+            message = heap;
+        }
+    }
+    write_line(level, time(NULL), message);
+    if (message != buffer)
+    {
+        free(message);
+    }
 }
 
 void log_info(const char *format, ...)
@@ -67,3 +252,85 @@ void log_error(const char *format, ...)
     log_message(LOG_LEVEL_ERROR, format, args);
     va_end(args);
 }
+
+void log_set_level(LogLevel level)
+{
+    atomic_store_explicit(&log_threshold, (int)level, memory_order_relaxed);
+}
+
+LogLevel log_get_level(void)
+{
+    return (LogLevel)atomic_load_explicit(&log_threshold, memory_order_relaxed);
+}
+
+bool log_level_enabled(LogLevel level)
+{
+    return (int)level >= atomic_load_explicit(&log_threshold, memory_order_relaxed);
+}
+
+bool log_async_start(size_t capacity)
+{
+    size_t slots = 2;
+    while (slots < capacity)
+    {
+        slots <<= 1;
+    }
+
+    pthread_mutex_lock(&log_async_lock);
+
+    if (atomic_load_explicit(&log_ring, memory_order_relaxed))
+    {
+        pthread_mutex_unlock(&log_async_lock);
+        return true;
+    }
+
+    LogRing *ring = calloc(1, sizeof(LogRing));
+    LogEntry *entries = ring ? calloc(slots, sizeof(LogEntry)) : NULL;
+    if (!entries)
+    {
+        free(ring);
+        pthread_mutex_unlock(&log_async_lock);
+        return false;
+    }
+
+    ring->entries = entries;
+    ring->mask = slots - 1;
+    for (size_t i = 0; i < slots; i++)
+    {
+        atomic_init(&entries[i].sequence, i);
+    }
+    atomic_init(&ring->running, true);
+
+    if (pthread_create(&ring->thread, NULL, log_writer_thread, ring) != 0)
+    {
+        free(entries);
+        free(ring);
+        pthread_mutex_unlock(&log_async_lock);
+        return false;
+    }
+
+    atomic_store_explicit(&log_ring, ring, memory_order_release);
+    pthread_mutex_unlock(&log_async_lock);
+    return true;
+}
+
+void log_async_stop(void)
+{
+    pthread_mutex_lock(&log_async_lock);
+
+    LogRing *ring = atomic_exchange(&log_ring, NULL);
+    if (ring)
+    {
+        // Wait for producers that loaded the ring before the exchange to publish their slot
+        while (atomic_load(&log_ring_users) != 0)
+        {
+            sched_yield();
+        }
+        atomic_store_explicit(&ring->running, false, memory_order_release);
+        pthread_join(ring->thread, NULL);
+        free(ring->entries);
+        free(ring);
+    }
+
+    pthread_mutex_unlock(&log_async_lock);
+}
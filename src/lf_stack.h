@@ -0,0 +1,67 @@
+#ifndef LF_STACK_H
+#define LF_STACK_H
+
+#include "object_pool.h"
+
+// Internal helpers shared by the pools that keep free slot indices on a
+// tagged Treiber stack: ObjectPool in OBJECT_POOL_MODE_LOCK_FREE, ShmPool
+// and SoaPool. The stack head packs an ABA tag above the top slot index,
+// and each free slot stores the index below it in a per-slot link.
+
+// Lock-free free list terminator stored in the links
+#define LF_NIL UINT32_MAX
+
+// Helpers to pack and unpack the tagged lock-free stack head
+#define LF_HEAD(index, tag) (((uint64_t)(tag) << 32) | (uint32_t)(index))
+#define LF_HEAD_INDEX(head) ((uint32_t)(head))
+#define LF_HEAD_TAG(head) ((uint32_t)((head) >> 32))
+
+// Helpers to locate a slot in an acquired bitmap
+#define BITMAP_WORDS(count) (((count) + 63) / 64)
+#define BITMAP_WORD(index) ((index) >> 6)
+#define BITMAP_BIT(index) ((uint64_t)1 << ((index) & 63))
+
+// Returns the link of slot index; context is whatever the pool needs to find it
+typedef OBJECT_POOL_ATOMIC(uint32_t) *(*lf_link_fn)(void *context, uint32_t index);
+
+// Link lookup for pools whose links are one flat array passed as context
+static inline OBJECT_POOL_ATOMIC(uint32_t) *lf_array_link(void *context, uint32_t index)
+{
+    return (OBJECT_POOL_ATOMIC(uint32_t) *)context + index;
+}
+
+// Pops one slot index off the stack, or returns LF_NIL if it is empty
+static inline uint32_t lf_stack_pop(OBJECT_POOL_ATOMIC(uint64_t) *stack, lf_link_fn link, void *context)
+{
+    uint64_t head = atomic_load_explicit(stack, memory_order_acquire);
+    for (;;)
+    {
+        uint32_t index = LF_HEAD_INDEX(head);
+        if (index == LF_NIL)
+        {
+            return LF_NIL;
+        }
+
+        // A stale read here is harmless: the tag makes the CAS below fail
+        uint32_t next = atomic_load_explicit(link(context, index), memory_order_relaxed);
+        if (atomic_compare_exchange_weak_explicit(stack, &head, LF_HEAD(next, LF_HEAD_TAG(head) + 1),
+                                                  memory_order_acquire, memory_order_acquire))
+        {
+            return index;
+        }
+    }
+}
+
+// Pushes a chain of slots, already linked from first down to the slot owning last_next, onto the stack
+static inline void lf_stack_push_chain(OBJECT_POOL_ATOMIC(uint64_t) *stack, uint32_t first,
+                                       OBJECT_POOL_ATOMIC(uint32_t) *last_next)
+{
+    uint64_t head = atomic_load_explicit(stack, memory_order_relaxed);
+    do
+    {
+        atomic_store_explicit(last_next, LF_HEAD_INDEX(head), memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(stack, &head, LF_HEAD(first, LF_HEAD_TAG(head) + 1),
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+#endif // LF_STACK_H
@@ -1,176 +1,2882 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
 #include "object_pool.h"
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include "cli_logger.h"
+#include "lf_stack.h"
+
+// Alignment of transparent huge pages on the platforms that support them
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+// mbind(2) policy giving the node preference while still allowing fallback
+#define NUMA_MPOL_PREFERRED 1
+#define NUMA_MAX_NODES 1024
+
+// Helpers to pack and unpack handles; generations run from 1 so no live handle is null
+#define HANDLE_INDEX_MASK (((uint32_t)1 << OBJECT_POOL_HANDLE_INDEX_BITS) - 1)
+#define HANDLE_GENERATIONS (UINT32_MAX >> OBJECT_POOL_HANDLE_INDEX_BITS)
+#define HANDLE_GENERATION(releases) ((uint32_t)((releases) % HANDLE_GENERATIONS) + 1)
+#define HANDLE(index, releases) ((HANDLE_GENERATION(releases) << OBJECT_POOL_HANDLE_INDEX_BITS) | (uint32_t)(index))
+
+// Debug builds pad every slot with a red zone and fill free objects with a poison pattern
+#ifdef OBJECT_POOL_DEBUG
+#ifndef OBJECT_POOL_REDZONE_SIZE
+#define OBJECT_POOL_REDZONE_SIZE 16
+#endif
+#define POISON_FREED 0xDD
+#define POISON_REDZONE 0xFB
+// AddressSanitizer tracks poisoning per 8-byte granule; slots start on their own granule
+#define DEBUG_SLOT_GRANULE 8
+#else
+#undef OBJECT_POOL_REDZONE_SIZE
+#define OBJECT_POOL_REDZONE_SIZE 0
+#endif
+
+// AddressSanitizer is told which slots are free, so any access to them is reported at once
+#if defined(__SANITIZE_ADDRESS__)
+#define OBJECT_POOL_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define OBJECT_POOL_ASAN 1
+#endif
+#endif
+
+#if defined(OBJECT_POOL_DEBUG) && defined(OBJECT_POOL_ASAN)
+#include <sanitizer/asan_interface.h>
+#define POISON_REGION(addr, size) ASAN_POISON_MEMORY_REGION(addr, size)
+#define UNPOISON_REGION(addr, size) ASAN_UNPOISON_MEMORY_REGION(addr, size)
+#else
+#define POISON_REGION(addr, size) ((void)(addr), (void)(size))
+#define UNPOISON_REGION(addr, size) ((void)(addr), (void)(size))
+#endif
+
+// Bitmap scan kernels are picked at runtime on x86 compilers that support target attributes
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(OBJECT_POOL_NO_SIMD)
+#define OBJECT_POOL_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Per-thread stack of free slot indices sitting in front of the shared free list
+typedef struct ObjectPoolThreadCache
+{
+    ObjectPool *pool;                   /**< Owning pool */
+    struct ObjectPoolThreadCache *prev; /**< Previous cache in the pool registry */
+    struct ObjectPoolThreadCache *next; /**< Next cache in the pool registry */
+    size_t count;                       /**< Number of cached free slots */
+    size_t slots[];                     /**< Cached slot indices */
+} ObjectPoolThreadCache;
+
+// Thread parked in object_pool_acquire_wait, living on the waiting thread's stack
+typedef struct ObjectPoolWaiter
+{
+    pthread_cond_t cond;            /**< Signalled when the waiter is dequeued */
+    bool signaled;                  /**< Set by the waker; the waiter is no longer queued */
+    void *object;                   /**< Object handed over directly (FIFO mode) */
+    struct ObjectPoolWaiter *next;  /**< Next waiter in arrival order */
+} ObjectPoolWaiter;
+
+// A reader thread's announced epoch; records are reused after their thread exits
+typedef struct ObjectPoolEpochRecord
+{
+    OBJECT_POOL_ATOMIC(uint64_t) epoch;    /**< Announced epoch << 1 | 1 inside a read section, 0 outside */
+    OBJECT_POOL_ATOMIC(bool) in_use;       /**< Owned by a live thread */
+    size_t nesting;                        /**< Read section depth of the owning thread */
+    struct ObjectPoolEpochRecord *next;    /**< Next registered record (guarded by retire_lock) */
+} ObjectPoolEpochRecord;
+
+static void thread_cache_destructor(void *arg);
+static void wake_waiters(ObjectPool *pool, size_t count);
+static bool add_chunk(ObjectPool *pool, size_t count);
+static void free_chunks(ObjectPool *pool);
+static bool release_one(ObjectPool *pool, void *obj, size_t *published);
+
+// Returns the current CLOCK_MONOTONIC time in nanoseconds
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+// Helper function to pick the calling thread's statistics stripe
+static inline ObjectPoolStatStripe *stat_stripe(ObjectPool *pool)
+{
+    static _Atomic unsigned next_stripe = 0;
+    static _Thread_local unsigned stripe = UINT_MAX;
+    if (stripe == UINT_MAX)
+    {
+        stripe = atomic_fetch_add_explicit(&next_stripe, 1, memory_order_relaxed) % OBJECT_POOL_STAT_STRIPES;
+    }
+    return &pool->stats[stripe];
+}
+
+// Helper function to bump a statistics counter
+static inline void stat_add(OBJECT_POOL_ATOMIC(uint64_t) *counter, uint64_t value)
+{
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+// Takes the pool lock, counting and timing the wait when another thread holds it
+static void pool_lock(ObjectPool *pool)
+{
+    if (pthread_mutex_trylock(&pool->lock) == 0)
+    {
+        return;
+    }
+
+    uint64_t start = monotonic_ns();
+    pthread_mutex_lock(&pool->lock);
+    ObjectPoolStatStripe *stripe = stat_stripe(pool);
+    stat_add(&stripe->lock_contentions, 1);
+    stat_add(&stripe->lock_wait_ns, monotonic_ns() - start);
+}
+
+// Helper function to read the pool size; it only changes under the lock, but lock-free paths read it without
+static inline size_t current_size(ObjectPool *pool)
+{
+    return atomic_load_explicit(&pool->pool_size, memory_order_relaxed);
+}
+
+// Helper function to raise the high-water mark after the shared free list shrank to available
+static inline void note_high_water(ObjectPool *pool, size_t available)
+{
+    size_t pool_size = current_size(pool);
+    size_t used = pool_size > available ? pool_size - available : 0;
+    size_t mark = atomic_load_explicit(&pool->high_water_mark, memory_order_relaxed);
+    while (used > mark &&
+           !atomic_compare_exchange_weak_explicit(&pool->high_water_mark, &mark, used,
+                                                  memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+}
 
 // Initializes the object pool
 bool object_pool_init(ObjectPool **pool_ptr, size_t initial_size, size_t object_size)
 {
-    if (!pool_ptr || initial_size == 0 || object_size == 0)
+    ObjectPoolConfig config = {0};
+    config.initial_size = initial_size;
+    config.object_size = object_size;
+    return object_pool_init_ex(pool_ptr, &config);
+}
+
+// Initializes the object pool from a configuration structure
+bool object_pool_init_ex(ObjectPool **pool_ptr, const ObjectPoolConfig *config)
+{
+    if (!pool_ptr || !config || config->initial_size == 0 || config->object_size == 0)
+    {
+        LOG_ERROR("Invalid parameters for object_pool_init.");
+        return false;
+    }
+
+    ObjectPool *pool = (ObjectPool *)calloc(1, sizeof(ObjectPool));
+    if (!pool)
+    {
+        LOG_ERROR("Failed to allocate memory for ObjectPool.");
+        return false;
+    }
+
+    pool->object_size = config->object_size;
+    pool->alignment = config->alignment;
+    pool->stride = config->object_size + OBJECT_POOL_REDZONE_SIZE;
+#ifdef OBJECT_POOL_DEBUG
+    // Neighbouring slots never share a shadow granule, so threads poisoning them do not race
+    pool->stride = (pool->stride + DEBUG_SLOT_GRANULE - 1) & ~(size_t)(DEBUG_SLOT_GRANULE - 1);
+#endif
+    if (pool->alignment > 0)
+    {
+        pool->stride = (pool->stride + pool->alignment - 1) & ~(pool->alignment - 1);
+    }
+    pool->huge_pages = config->huge_pages;
+    pool->numa_bind = config->numa_bind;
+    pool->numa_node = config->numa_node;
+    pool->own_pages = config->own_pages;
+    pool->constructor = config->constructor;
+    pool->destructor = config->destructor;
+    pool->reset = config->reset;
+    pool->hook_data = config->hook_data;
+    pool->wait_fifo = config->wait_fifo;
+    pool->handles = config->handles;
+    atomic_init(&pool->waiter_count, 0);
+    atomic_init(&pool->epoch, 1);
+    atomic_init(&pool->epoch_key_ready, false);
+    pool->mode = config->mode;
+    pool->thread_cache_size = config->thread_cache_size;
+    pool->growth = config->growth;
+    pool->growth_step = config->growth_step ? config->growth_step : config->initial_size;
+    pool->max_size = config->max_size;
+    pool->idle_shrink_ms = config->idle_shrink_ms;
+    atomic_init(&pool->available, 0);
+    atomic_init(&pool->chunk_count, 0);
+    atomic_init(&pool->free_head, LF_HEAD(LF_NIL, 0));
+    atomic_init(&pool->high_water_mark, 0);
+    atomic_init(&pool->corruptions, 0);
+
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE && !atomic_is_lock_free(&pool->free_head))
+    {
+        LOG_ERROR("Lock-free mode is not available on this platform.");
+        free(pool);
+        return false;
+    }
+
+    if ((pool->alignment & (pool->alignment - 1)) != 0 || pool->alignment > OBJECT_POOL_MAX_ALIGNMENT)
+    {
+        LOG_ERROR("Alignment must be a power of two no larger than %d.", OBJECT_POOL_MAX_ALIGNMENT);
+        free(pool);
+        return false;
+    }
+
+    if (pool->numa_bind && (pool->numa_node < 0 || pool->numa_node >= NUMA_MAX_NODES))
+    {
+        LOG_ERROR("NUMA node %d is out of range.", pool->numa_node);
+        free(pool);
+        return false;
+    }
+
+    if (pool->max_size != 0 && pool->max_size < config->initial_size)
+    {
+        LOG_ERROR("Maximum pool size is smaller than the initial size.");
+        free(pool);
+        return false;
+    }
+
+    // Freeing a chunk is only safe when every chunk access happens under the lock
+    if (pool->idle_shrink_ms > 0 && (pool->mode != OBJECT_POOL_MODE_MUTEX || pool->thread_cache_size > 0))
+    {
+        LOG_ERROR("Idle shrinking requires mutex mode without thread caches.");
+        free(pool);
+        return false;
+    }
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0)
+    {
+        LOG_ERROR("Failed to initialize mutex.");
+        free(pool);
+        return false;
+    }
+
+    if (pthread_mutex_init(&pool->wait_lock, NULL) != 0)
+    {
+        LOG_ERROR("Failed to initialize mutex.");
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return false;
+    }
+
+    if (pthread_mutex_init(&pool->retire_lock, NULL) != 0)
+    {
+        LOG_ERROR("Failed to initialize mutex.");
+        pthread_mutex_destroy(&pool->wait_lock);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return false;
+    }
+
+    if (!add_chunk(pool, config->initial_size))
+    {
+        LOG_ERROR("Failed to allocate memory for object pool.");
+        pthread_mutex_destroy(&pool->retire_lock);
+        pthread_mutex_destroy(&pool->wait_lock);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return false;
+    }
+
+    if (pool->thread_cache_size > 0 &&
+        pthread_key_create(&pool->thread_cache_key, thread_cache_destructor) != 0)
+    {
+        LOG_ERROR("Failed to create thread cache key.");
+        free_chunks(pool);
+        pthread_mutex_destroy(&pool->retire_lock);
+        pthread_mutex_destroy(&pool->wait_lock);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return false;
+    }
+
+    LOG_INFO("Object pool initialized with %zu objects.", config->initial_size);
+    *pool_ptr = pool;
+    return true;
+}
+
+// Helper function to find the chunk holding a pool-wide slot index
+static ObjectPoolChunk *chunk_for_index(ObjectPool *pool, size_t index)
+{
+    size_t lo = 0;
+    size_t hi = atomic_load_explicit(&pool->chunk_count, memory_order_acquire) - 1;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi + 1) / 2;
+        if (pool->chunks[mid].first_index <= index)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return &pool->chunks[lo];
+}
+
+// Helper function to find the chunk and chunk-local slot of an object, or NULL if it is not a slot
+static ObjectPoolChunk *chunk_for_object(ObjectPool *pool, const void *obj, size_t *local)
+{
+    uintptr_t ptr = (uintptr_t)obj;
+    size_t count = atomic_load_explicit(&pool->chunk_count, memory_order_acquire);
+    for (size_t i = 0; i < count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        uintptr_t base = (uintptr_t)chunk->memory;
+        if (chunk->memory && ptr >= base && ptr - base < chunk->count * pool->stride)
+        {
+            size_t offset = (size_t)(ptr - base);
+            if (offset % pool->stride != 0)
+            {
+                return NULL;
+            }
+            *local = offset / pool->stride;
+            return chunk;
+        }
+    }
+    return NULL;
+}
+
+#ifdef OBJECT_POOL_DEBUG
+// Helper function to count and report a corruption found by the debug checks
+static void debug_report(ObjectPool *pool, const char *what, const void *obj, size_t offset)
+{
+    atomic_fetch_add_explicit(&pool->corruptions, 1, memory_order_relaxed);
+    LOG_ERROR("Object %p: %s at byte %zu.", obj, what, offset);
+}
+
+// Helper function to check whether free objects are poisoned; lifecycle hooks keep their state across reuse
+static inline bool debug_poisons_contents(const ObjectPool *pool)
+{
+    return !pool->constructor && !pool->destructor && !pool->reset;
+}
+
+// Helper function to find the first byte in [begin, end) that differs from pattern, or end
+static size_t debug_find_mismatch(const unsigned char *bytes, size_t begin, size_t end, unsigned char pattern)
+{
+    while (begin < end && bytes[begin] == pattern)
+    {
+        begin++;
+    }
+    return begin;
+}
+
+// Helper function to check a slot's red zone and repair it so one overflow is reported once
+static void debug_check_redzone(ObjectPool *pool, unsigned char *obj)
+{
+    UNPOISON_REGION(obj + pool->object_size, pool->stride - pool->object_size);
+    size_t offset = debug_find_mismatch(obj, pool->object_size, pool->stride, POISON_REDZONE);
+    if (offset < pool->stride)
+    {
+        debug_report(pool, "red zone overwritten", obj, offset);
+        memset(obj + pool->object_size, POISON_REDZONE, pool->stride - pool->object_size);
+    }
+    POISON_REGION(obj + pool->object_size, pool->stride - pool->object_size);
+}
+
+// Helper function to fill the red zones of new chunk memory and poison its objects, all of which are free
+static void debug_prepare_chunk(ObjectPool *pool, char *memory, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        char *obj = memory + i * pool->stride;
+        memset(obj + pool->object_size, POISON_REDZONE, pool->stride - pool->object_size);
+        if (debug_poisons_contents(pool))
+        {
+            memset(obj, POISON_FREED, pool->object_size);
+        }
+    }
+    POISON_REGION(memory, count * pool->stride);
+}
+
+// Helper function to make a chunk's memory addressable again before it is torn down
+static inline void debug_unpoison_chunk(ObjectPool *pool, ObjectPoolChunk *chunk)
+{
+    UNPOISON_REGION(chunk->memory, chunk->count * pool->stride);
+}
+
+// Helper function to check an object leaving the free list for writes made while it was free
+static void debug_on_acquire(ObjectPool *pool, unsigned char *obj)
+{
+    UNPOISON_REGION(obj, pool->object_size);
+    if (debug_poisons_contents(pool))
+    {
+        size_t offset = debug_find_mismatch(obj, 0, pool->object_size, POISON_FREED);
+        if (offset < pool->object_size)
+        {
+            debug_report(pool, "written after release", obj, offset);
+        }
+    }
+    debug_check_redzone(pool, obj);
+}
+
+// Helper function to check an object's red zone on release and poison its contents
+static void debug_on_release(ObjectPool *pool, unsigned char *obj)
+{
+    debug_check_redzone(pool, obj);
+    if (debug_poisons_contents(pool))
+    {
+        memset(obj, POISON_FREED, pool->object_size);
+    }
+    POISON_REGION(obj, pool->object_size);
+}
+#else
+#define debug_prepare_chunk(pool, memory, count) ((void)0)
+#define debug_unpoison_chunk(pool, chunk) ((void)0)
+#define debug_on_acquire(pool, obj) ((void)0)
+#define debug_on_release(pool, obj) ((void)0)
+#endif
+
+// Returns the first word in [begin, end) that differs from skip, or end if there is none
+typedef size_t (*scan_kernel)(const uint64_t *words, size_t begin, size_t end, uint64_t skip);
+
+// Bitmap words are scanned as plain uint64_t; the kernels only locate candidate words,
+// which callers then re-read atomically
+_Static_assert(sizeof(OBJECT_POOL_ATOMIC(uint64_t)) == sizeof(uint64_t), "atomic bitmap words must be plain words");
+
+// Helper function to scan bitmap words one at a time
+static size_t scan_words_scalar(const uint64_t *words, size_t begin, size_t end, uint64_t skip)
+{
+    while (begin < end && words[begin] == skip)
+    {
+        begin++;
+    }
+    return begin;
+}
+
+#ifdef OBJECT_POOL_X86_SIMD
+// Helper function to scan bitmap words two at a time with SSE4.1
+__attribute__((target("sse4.1"))) static size_t scan_words_sse41(const uint64_t *words, size_t begin, size_t end,
+                                                                  uint64_t skip)
+{
+    __m128i pattern = _mm_set1_epi64x((long long)skip);
+    for (; begin + 2 <= end; begin += 2)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(words + begin));
+        int equal = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(block, pattern)));
+        if (equal != 0x3)
+        {
+            return begin + (size_t)__builtin_ctz(~equal & 0x3);
+        }
+    }
+    return scan_words_scalar(words, begin, end, skip);
+}
+
+// Helper function to scan bitmap words with AVX2, eight per iteration (512 slots)
+__attribute__((target("avx2"))) static size_t scan_words_avx2(const uint64_t *words, size_t begin, size_t end,
+                                                              uint64_t skip)
+{
+    __m256i pattern = _mm256_set1_epi64x((long long)skip);
+    __m256i ones = _mm256_set1_epi64x(-1);
+    for (; begin + 8 <= end; begin += 8)
+    {
+        __m256i low = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(words + begin)), pattern);
+        __m256i high = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(words + begin + 4)), pattern);
+        if (!_mm256_testc_si256(_mm256_and_si256(low, high), ones))
+        {
+            break;
+        }
+    }
+    for (; begin + 4 <= end; begin += 4)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(words + begin));
+        int equal = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, pattern)));
+        if (equal != 0xF)
+        {
+            return begin + (size_t)__builtin_ctz(~equal & 0xF);
+        }
+    }
+    return scan_words_scalar(words, begin, end, skip);
+}
+#endif
+
+static scan_kernel scan_words_impl = scan_words_scalar;
+static const char *scan_kernel_name = "scalar";
+static pthread_once_t scan_kernel_once = PTHREAD_ONCE_INIT;
+
+// Helper function to pick the widest scan kernel the CPU supports
+static void select_scan_kernel(void)
+{
+#ifdef OBJECT_POOL_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        scan_words_impl = scan_words_avx2;
+        scan_kernel_name = "avx2";
+    }
+    else if (__builtin_cpu_supports("sse4.1"))
+    {
+        scan_words_impl = scan_words_sse41;
+        scan_kernel_name = "sse4.1";
+    }
+#endif
+    LOG_INFO("Bitmap scan kernel: %s.", scan_kernel_name);
+}
+
+// Helper function to find the first word in [begin, end) that differs from skip with the selected kernel
+static inline size_t scan_words(const uint64_t *words, size_t begin, size_t end, uint64_t skip)
+{
+    pthread_once(&scan_kernel_once, select_scan_kernel);
+    return scan_words_impl(words, begin, end, skip);
+}
+
+// Helper function to find the first word of an acquired bitmap in [begin, end) that differs from skip
+static inline size_t scan_bitmap(const OBJECT_POOL_ATOMIC(uint64_t) *bitmap, size_t begin, size_t end, uint64_t skip)
+{
+    return scan_words((const uint64_t *)bitmap, begin, end, skip);
+}
+
+// Helper function to find the first slot at or after local whose acquired bit equals acquired
+static size_t chunk_find(const ObjectPoolChunk *chunk, size_t local, bool acquired)
+{
+    size_t words = BITMAP_WORDS(chunk->count);
+    uint64_t skip = acquired ? 0 : ~(uint64_t)0;
+    size_t word = BITMAP_WORD(local);
+    if (word >= words)
+    {
+        return chunk->count;
+    }
+
+    uint64_t bits = (atomic_load_explicit(&chunk->acquired_bitmap[word], memory_order_relaxed) ^ skip) &
+                    (~(uint64_t)0 << (local & 63));
+    while (!bits)
+    {
+        word = scan_bitmap(chunk->acquired_bitmap, word + 1, words, skip);
+        if (word >= words)
+        {
+            return chunk->count;
+        }
+        bits = atomic_load_explicit(&chunk->acquired_bitmap[word], memory_order_relaxed) ^ skip;
+    }
+
+    // Bits past the end of the last word are never set, so they read as free
+    size_t found = word * 64 + (size_t)__builtin_ctzll(bits);
+    return found < chunk->count ? found : chunk->count;
+}
+
+// Marks a slot as acquired and returns its address
+static inline void *acquire_slot(ObjectPool *pool, size_t index)
+{
+    ObjectPoolChunk *chunk = chunk_for_index(pool, index);
+    size_t local = index - chunk->first_index;
+    atomic_fetch_or_explicit(&chunk->acquired_bitmap[BITMAP_WORD(local)], BITMAP_BIT(local), memory_order_relaxed);
+    char *obj = chunk->memory + local * pool->stride;
+    debug_on_acquire(pool, (unsigned char *)obj);
+    return obj;
+}
+
+// Helper function to validate and unmark an object being released
+static bool release_slot(ObjectPool *pool, void *obj, size_t *index)
+{
+    size_t local;
+    ObjectPoolChunk *chunk = chunk_for_object(pool, obj, &local);
+    if (chunk)
+    {
+        uint64_t bit = BITMAP_BIT(local);
+        uint64_t old = atomic_fetch_and_explicit(&chunk->acquired_bitmap[BITMAP_WORD(local)], ~bit,
+                                                 memory_order_relaxed);
+        if (old & bit)
+        {
+            debug_on_release(pool, (unsigned char *)obj);
+            if (chunk->generations)
+            {
+                // Outstanding handles to this object go stale
+                atomic_fetch_add_explicit(&chunk->generations[local], 1, memory_order_release);
+            }
+            *index = chunk->first_index + local;
+            return true;
+        }
+#ifdef OBJECT_POOL_DEBUG
+        atomic_fetch_add_explicit(&pool->corruptions, 1, memory_order_relaxed);
+        LOG_ERROR("Double release of object %p.", obj);
+        return false;
+#endif
+    }
+
+    LOG_WARNING("Attempted to release an object not acquired from the pool.");
+    return false;
+}
+
+// Helper function to get the free-list link of a slot
+static inline OBJECT_POOL_ATOMIC(uint32_t) *free_next_of(ObjectPool *pool, uint32_t index)
+{
+    ObjectPoolChunk *chunk = chunk_for_index(pool, index);
+    return &chunk->free_next[index - chunk->first_index];
+}
+
+// Link lookup handed to lf_stack_pop; links live in the chunk owning the slot
+static OBJECT_POOL_ATOMIC(uint32_t) *chunk_link(void *pool, uint32_t index)
+{
+    return free_next_of(pool, index);
+}
+
+// Pops one slot index off the lock-free stack, or returns LF_NIL if it is empty
+static uint32_t lock_free_pop(ObjectPool *pool)
+{
+    uint32_t index = lf_stack_pop(&pool->free_head, chunk_link, pool);
+    if (index != LF_NIL)
+    {
+        note_high_water(pool, atomic_fetch_sub_explicit(&pool->available, 1, memory_order_relaxed) - 1);
+    }
+    return index;
+}
+
+// Pops up to count slots off the lock-free stack with one CAS, returning how many were taken
+static size_t lock_free_pop_chain(ObjectPool *pool, size_t count, uint32_t *first)
+{
+    uint64_t head = atomic_load_explicit(&pool->free_head, memory_order_acquire);
+    for (;;)
+    {
+        uint32_t index = LF_HEAD_INDEX(head);
+        if (index == LF_NIL)
+        {
+            return 0;
+        }
+
+        // Links are only rewritten by pushes and pops, both of which change the
+        // head tag, so an unchanged head means the walked chain is still intact
+        size_t taken = 1;
+        uint32_t next = atomic_load_explicit(free_next_of(pool, index), memory_order_relaxed);
+        while (taken < count && next != LF_NIL)
+        {
+            next = atomic_load_explicit(free_next_of(pool, next), memory_order_relaxed);
+            taken++;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&pool->free_head, &head, LF_HEAD(next, LF_HEAD_TAG(head) + 1),
+                                                  memory_order_acquire, memory_order_acquire))
+        {
+            note_high_water(pool, atomic_fetch_sub_explicit(&pool->available, taken, memory_order_relaxed) - taken);
+            *first = index;
+            return taken;
+        }
+    }
+}
+
+// Pushes a chain of count slots, already linked from first to last, onto the lock-free stack
+static void lock_free_push_chain(ObjectPool *pool, uint32_t first, uint32_t last, size_t count)
+{
+    lf_stack_push_chain(&pool->free_head, first, free_next_of(pool, last));
+    atomic_fetch_add_explicit(&pool->available, count, memory_order_relaxed);
+}
+
+// Pushes one slot index onto the lock-free stack
+static inline void lock_free_push(ObjectPool *pool, uint32_t index)
+{
+    lock_free_push_chain(pool, index, index, 1);
+}
+
+// Moves up to count free slot indices from the shared free list into slots
+static size_t shared_pop(ObjectPool *pool, size_t *slots, size_t count)
+{
+    size_t moved = 0;
+
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        while (moved < count)
+        {
+            uint32_t index = lock_free_pop(pool);
+            if (index == LF_NIL)
+            {
+                break;
+            }
+            slots[moved++] = index;
+        }
+        return moved;
+    }
+
+    pool_lock(pool);
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    while (moved < count && available > 0)
+    {
+        slots[moved++] = pool->free_list[--available];
+    }
+    atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+    note_high_water(pool, available);
+    pthread_mutex_unlock(&pool->lock);
+    return moved;
+}
+
+// Returns count free slot indices to the shared free list
+static void shared_push(ObjectPool *pool, const size_t *slots, size_t count)
+{
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            lock_free_push(pool, (uint32_t)slots[i]);
+        }
+        return;
+    }
+
+    pool_lock(pool);
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    memcpy(pool->free_list + available, slots, count * sizeof(*slots));
+    atomic_store_explicit(&pool->available, available + count, memory_order_relaxed);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Helper function to map chunk memory with mmap, honouring the huge page and NUMA options
+static char *map_chunk_memory(ObjectPool *pool, size_t bytes, size_t *mapped_size)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t align = pool->huge_pages ? HUGE_PAGE_SIZE : page;
+    size_t length = (bytes + align - 1) & ~(align - 1);
+
+    // Over-map so the slab can start on a huge page boundary, then trim the slack
+    size_t slack = align > page ? align : 0;
+    char *raw = mmap(NULL, length + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    char *memory = raw;
+    if (slack > 0)
+    {
+        memory = (char *)(((uintptr_t)raw + align - 1) & ~(uintptr_t)(align - 1));
+        if (memory > raw)
+        {
+            munmap(raw, (size_t)(memory - raw));
+        }
+        if (raw + length + slack > memory + length)
+        {
+            munmap(memory + length, (size_t)(raw + length + slack - (memory + length)));
+        }
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (pool->huge_pages && madvise(memory, length, MADV_HUGEPAGE) != 0)
+    {
+        LOG_WARNING("Transparent huge pages are not available; using regular pages.");
+    }
+#else
+    if (pool->huge_pages)
+    {
+        LOG_WARNING("Transparent huge pages are not supported on this platform.");
+    }
+#endif
+
+    if (pool->numa_bind)
+    {
+        bool bound = false;
+#ifdef SYS_mbind
+        unsigned long nodemask[NUMA_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+        nodemask[pool->numa_node / (8 * sizeof(unsigned long))] |= 1UL << (pool->numa_node % (8 * sizeof(unsigned long)));
+        bound = syscall(SYS_mbind, memory, length, NUMA_MPOL_PREFERRED, nodemask, NUMA_MAX_NODES + 1, 0) == 0;
+#endif
+        if (!bound)
+        {
+            LOG_WARNING("Failed to bind chunk memory to NUMA node %d; relying on first touch.", pool->numa_node);
+        }
+
+        // Fault every page in now so placement happens here rather than on the first acquire
+        for (size_t offset = 0; offset < length; offset += page)
+        {
+            memory[offset] = 0;
+        }
+    }
+
+    *mapped_size = length;
+    return memory;
+}
+
+// Helper function to allocate the memory for a chunk of count slots
+static bool alloc_chunk_memory(ObjectPool *pool, ObjectPoolChunk *chunk, size_t count)
+{
+    size_t bytes = count * pool->stride;
+    chunk->mapped_size = 0;
+
+    if (pool->huge_pages || pool->numa_bind || pool->own_pages)
+    {
+        chunk->memory = map_chunk_memory(pool, bytes, &chunk->mapped_size);
+    }
+    else if (pool->alignment > 0)
+    {
+        // The stride is a multiple of the alignment, so bytes already is as aligned_alloc requires
+        chunk->memory = aligned_alloc(pool->alignment, bytes);
+    }
+    else
+    {
+        chunk->memory = malloc(bytes);
+    }
+
+    if (!chunk->memory)
+    {
+        return false;
+    }
+    debug_prepare_chunk(pool, chunk->memory, count);
+    return true;
+}
+
+// Helper function to free a chunk's memory with the allocator that produced it
+static void free_chunk_memory(ObjectPoolChunk *chunk)
+{
+    if (chunk->mapped_size > 0)
+    {
+        munmap(chunk->memory, chunk->mapped_size);
+    }
+    else
+    {
+        free(chunk->memory);
+    }
+    chunk->memory = NULL;
+    chunk->mapped_size = 0;
+}
+
+// Helper function to check whether the pool tracks which slots hold constructed objects
+static inline bool tracks_construction(const ObjectPool *pool)
+{
+    return pool->constructor || pool->destructor;
+}
+
+// Helper function to run the destructor on every constructed object in a chunk and forget them
+static void destroy_constructed(ObjectPool *pool, ObjectPoolChunk *chunk)
+{
+    if (!chunk->constructed_bitmap)
+    {
+        return;
+    }
+
+    for (size_t word = 0; word < BITMAP_WORDS(chunk->count); word++)
+    {
+        uint64_t bits = atomic_exchange_explicit(&chunk->constructed_bitmap[word], 0, memory_order_relaxed);
+        while (bits && pool->destructor)
+        {
+            size_t local = word * 64 + (size_t)__builtin_ctzll(bits);
+            pool->destructor(chunk->memory + local * pool->stride, pool->hook_data);
+            bits &= bits - 1;
+        }
+    }
+}
+
+// Allocates a chunk of count slots and adds them to the free list (caller holds the lock)
+static bool add_chunk(ObjectPool *pool, size_t count)
+{
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    if (chunk_count == OBJECT_POOL_MAX_CHUNKS)
+    {
+        LOG_ERROR("Object pool already has the maximum of %d chunks.", OBJECT_POOL_MAX_CHUNKS);
+        return false;
+    }
+
+    size_t first_index = 0;
+    if (chunk_count > 0)
+    {
+        first_index = pool->chunks[chunk_count - 1].first_index + pool->chunks[chunk_count - 1].count;
+    }
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE && count >= LF_NIL - first_index)
+    {
+        LOG_ERROR("Lock-free pools are limited to %u objects.", LF_NIL - 1);
+        return false;
+    }
+
+    ObjectPoolChunk *chunk = &pool->chunks[chunk_count];
+    alloc_chunk_memory(pool, chunk, count);
+    chunk->acquired_bitmap = calloc(BITMAP_WORDS(count), sizeof(*chunk->acquired_bitmap));
+    chunk->constructed_bitmap = NULL;
+    if (tracks_construction(pool))
+    {
+        chunk->constructed_bitmap = calloc(BITMAP_WORDS(count), sizeof(*chunk->constructed_bitmap));
+    }
+    chunk->generations = NULL;
+    if (pool->handles)
+    {
+        chunk->generations = calloc(count, sizeof(*chunk->generations));
+    }
+    chunk->free_next = NULL;
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        chunk->free_next = malloc(count * sizeof(*chunk->free_next));
+    }
+    else
+    {
+        // The free list is only touched under the lock, so reallocating it is safe
+        size_t *free_list = realloc(pool->free_list, (first_index + count) * sizeof(*free_list));
+        if (free_list)
+        {
+            pool->free_list = free_list;
+        }
+        else if (chunk->memory)
+        {
+            free_chunk_memory(chunk);
+        }
+    }
+
+    if (!chunk->memory || !chunk->acquired_bitmap ||
+        (tracks_construction(pool) && !chunk->constructed_bitmap) || (pool->handles && !chunk->generations) ||
+        (pool->mode == OBJECT_POOL_MODE_LOCK_FREE && !chunk->free_next))
+    {
+        if (chunk->memory)
+        {
+            free_chunk_memory(chunk);
+        }
+        free(chunk->acquired_bitmap);
+        free(chunk->constructed_bitmap);
+        free(chunk->generations);
+        free(chunk->free_next);
+        memset(chunk, 0, sizeof(*chunk));
+        return false;
+    }
+
+    chunk->first_index = first_index;
+    chunk->count = count;
+
+    // Link the new slots in ascending order before publishing the chunk
+    if (chunk->free_next)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            atomic_init(&chunk->free_next[i], (uint32_t)(first_index + i + 1));
+        }
+    }
+    atomic_store_explicit(&pool->chunk_count, chunk_count + 1, memory_order_release);
+    atomic_fetch_add_explicit(&pool->pool_size, count, memory_order_relaxed);
+
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        lock_free_push_chain(pool, (uint32_t)first_index, (uint32_t)(first_index + count - 1), count);
+        return true;
+    }
+
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    for (size_t i = count; i > 0; i--)
+    {
+        pool->free_list[available++] = first_index + i - 1;
+    }
+    atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+    return true;
+}
+
+// Frees every chunk and the free list
+static void free_chunks(ObjectPool *pool)
+{
+    size_t count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    for (size_t i = 0; i < count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        if (chunk->memory)
+        {
+            debug_unpoison_chunk(pool, chunk);
+            destroy_constructed(pool, chunk);
+            free_chunk_memory(chunk);
+        }
+        free(chunk->acquired_bitmap);
+        free(chunk->constructed_bitmap);
+        free(chunk->generations);
+        free(chunk->free_next);
+        memset(chunk, 0, sizeof(*chunk));
+    }
+    atomic_store_explicit(&pool->chunk_count, 0, memory_order_relaxed);
+    free(pool->free_list);
+    pool->free_list = NULL;
+}
+
+// Reallocates a chunk freed by idle shrinking and adds its slots back to the free list (caller holds the lock)
+static bool revive_chunk(ObjectPool *pool, ObjectPoolChunk *chunk)
+{
+    if (!alloc_chunk_memory(pool, chunk, chunk->count))
+    {
+        return false;
+    }
+
+    chunk->idle_since_ms = 0;
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    for (size_t i = chunk->count; i > 0; i--)
+    {
+        pool->free_list[available++] = chunk->first_index + i - 1;
+    }
+    atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+    atomic_fetch_add_explicit(&pool->pool_size, chunk->count, memory_order_relaxed);
+    return true;
+}
+
+// Grows an exhausted pool according to its growth policy (caller holds the lock)
+static bool grow_locked(ObjectPool *pool)
+{
+    if (pool->growth == OBJECT_POOL_GROWTH_NONE)
+    {
+        return false;
+    }
+
+    size_t pool_size = current_size(pool);
+    size_t room = SIZE_MAX;
+    if (pool->max_size != 0)
+    {
+        if (pool_size >= pool->max_size)
+        {
+            return false;
+        }
+        room = pool->max_size - pool_size;
+    }
+
+    // Chunks freed by idle shrinking are reused before new ones are added
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        if (!chunk->memory && chunk->count <= room && revive_chunk(pool, chunk))
+        {
+            pool->resize_count++;
+            LOG_INFO("Object pool grew to %zu objects.", current_size(pool));
+            return true;
+        }
+    }
+
+    size_t count = pool->growth == OBJECT_POOL_GROWTH_GEOMETRIC ? pool_size : pool->growth_step;
+    if (count > room)
+    {
+        count = room;
+    }
+    if (!add_chunk(pool, count))
+    {
+        return false;
+    }
+
+    pool->resize_count++;
+    LOG_INFO("Object pool grew to %zu objects.", current_size(pool));
+    return true;
+}
+
+// Helper function to check whether the shared free list can be popped from (caller holds the lock)
+static bool shared_has_free(ObjectPool *pool)
+{
+    // The lock-free counter trails the stack and can be non-zero while it is empty, so look at the head
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        return LF_HEAD_INDEX(atomic_load_explicit(&pool->free_head, memory_order_acquire)) != LF_NIL;
+    }
+    return atomic_load_explicit(&pool->available, memory_order_relaxed) > 0;
+}
+
+// Grows an exhausted pool unless another thread already refilled it
+static bool grow(ObjectPool *pool)
+{
+    if (pool->growth == OBJECT_POOL_GROWTH_NONE)
+    {
+        return false;
+    }
+
+    pool_lock(pool);
+    bool grown = shared_has_free(pool) || grow_locked(pool);
+    pthread_mutex_unlock(&pool->lock);
+    return grown;
+}
+
+// Returns the current CLOCK_MONOTONIC time in milliseconds
+static uint64_t monotonic_ms(void)
+{
+    return monotonic_ns() / 1000000;
+}
+
+// Helper function to check whether a chunk has no acquired slots
+static bool chunk_is_idle(const ObjectPoolChunk *chunk)
+{
+    return chunk_find(chunk, 0, true) == chunk->count;
+}
+
+// Frees an idle chunk's memory and drops its slots from the free list (caller holds the lock)
+static void release_chunk_locked(ObjectPool *pool, ObjectPoolChunk *chunk)
+{
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    size_t kept = 0;
+    for (size_t i = 0; i < available; i++)
+    {
+        size_t index = pool->free_list[i];
+        if (index < chunk->first_index || index >= chunk->first_index + chunk->count)
+        {
+            pool->free_list[kept++] = index;
+        }
+    }
+    atomic_store_explicit(&pool->available, kept, memory_order_relaxed);
+
+    debug_unpoison_chunk(pool, chunk);
+    destroy_constructed(pool, chunk);
+    free_chunk_memory(chunk);
+    chunk->idle_since_ms = 0;
+    atomic_fetch_sub_explicit(&pool->pool_size, chunk->count, memory_order_relaxed);
+    pool->shrink_count++;
+}
+
+// Frees grown chunks that have been idle for at least idle_shrink_ms (caller holds the lock)
+static void shrink_idle_locked(ObjectPool *pool)
+{
+    uint64_t now = monotonic_ms();
+    if (now - pool->last_shrink_check_ms < pool->idle_shrink_ms || pool->active_snapshots > 0)
+    {
+        return;
+    }
+    pool->last_shrink_check_ms = now;
+
+    // The initial chunk is never freed
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    for (size_t i = 1; i < chunk_count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        if (!chunk->memory)
+        {
+            continue;
+        }
+        if (!chunk_is_idle(chunk))
+        {
+            chunk->idle_since_ms = 0;
+        }
+        else if (chunk->idle_since_ms == 0)
+        {
+            chunk->idle_since_ms = now;
+        }
+        else if (now - chunk->idle_since_ms >= pool->idle_shrink_ms)
+        {
+            release_chunk_locked(pool, chunk);
+            LOG_INFO("Object pool shrank to %zu objects.", current_size(pool));
+        }
+    }
+}
+
+// Frees every grown chunk that is currently completely unused
+size_t object_pool_shrink(ObjectPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_shrink received NULL pool pointer.");
+        return 0;
+    }
+
+    if (pool->mode != OBJECT_POOL_MODE_MUTEX || pool->thread_cache_size > 0)
+    {
+        LOG_WARNING("object_pool_shrink requires mutex mode without thread caches.");
+        return 0;
+    }
+
+    pool_lock(pool);
+    size_t before = current_size(pool);
+    // Chunks pinned by a snapshot iteration are left for a later shrink
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    for (size_t i = 1; i < chunk_count && pool->active_snapshots == 0; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        if (chunk->memory && chunk_is_idle(chunk))
+        {
+            release_chunk_locked(pool, chunk);
+        }
+    }
+    size_t removed = before - current_size(pool);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (removed > 0)
+    {
+        LOG_INFO("Object pool shrank to %zu objects.", before - removed);
+    }
+    return removed;
+}
+
+// Helper function to count the acquired slots of a chunk
+static size_t chunk_live_count(const ObjectPoolChunk *chunk)
+{
+    size_t live = 0;
+    for (size_t word = 0; word < BITMAP_WORDS(chunk->count); word++)
+    {
+        live += (size_t)__builtin_popcountll(atomic_load_explicit(&chunk->acquired_bitmap[word], memory_order_relaxed));
+    }
+    return live;
+}
+
+// Helper function to pick the sparsest grown chunk whose objects fit in the other chunks' free slots
+static ObjectPoolChunk *compaction_victim(ObjectPool *pool)
+{
+    ObjectPoolChunk *victim = NULL;
+    size_t victim_live = SIZE_MAX;
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    for (size_t i = 1; i < chunk_count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        if (!chunk->memory)
+        {
+            continue;
+        }
+
+        // Slots of the chunk that are not acquired are on the free list, bar any a batch acquire is claiming
+        size_t live = chunk_live_count(chunk);
+        size_t own_free = chunk->count - live < available ? chunk->count - live : available;
+        if (live <= available - own_free && live <= victim_live)
+        {
+            victim = chunk;
+            victim_live = live;
+        }
+    }
+    return victim;
+}
+
+// Helper function to order the free list so pops take the lowest chunks first and the victim's slots last
+static bool order_free_list_locked(ObjectPool *pool, const ObjectPoolChunk *victim, size_t *victim_free)
+{
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    size_t *ordered = malloc((available ? available : 1) * sizeof(size_t));
+    if (!ordered)
+    {
+        LOG_ERROR("Failed to allocate memory for compaction.");
+        return false;
+    }
+
+    // Counting sort by rank: the victim at the bottom, then chunks from the last one down to the first
+    size_t starts[OBJECT_POOL_MAX_CHUNKS + 1] = {0};
+    for (size_t i = 0; i < available; i++)
+    {
+        ObjectPoolChunk *chunk = chunk_for_index(pool, pool->free_list[i]);
+        starts[chunk == victim ? 0 : chunk_count - (size_t)(chunk - pool->chunks)]++;
+    }
+    *victim_free = starts[0];
+    for (size_t rank = 0, sum = 0; rank <= chunk_count; rank++)
+    {
+        size_t count = starts[rank];
+        starts[rank] = sum;
+        sum += count;
+    }
+    for (size_t i = 0; i < available; i++)
+    {
+        ObjectPoolChunk *chunk = chunk_for_index(pool, pool->free_list[i]);
+        ordered[starts[chunk == victim ? 0 : chunk_count - (size_t)(chunk - pool->chunks)]++] = pool->free_list[i];
+    }
+
+    memcpy(pool->free_list, ordered, available * sizeof(size_t));
+    free(ordered);
+    return true;
+}
+
+// Helper function to carry a moved object's constructed bit to its new slot, destroying what it overwrites
+static void move_constructed(ObjectPool *pool, ObjectPoolChunk *from, size_t from_local, size_t to_index, void *to)
+{
+    if (!from->constructed_bitmap)
+    {
+        return;
+    }
+
+    ObjectPoolChunk *chunk = chunk_for_index(pool, to_index);
+    size_t local = to_index - chunk->first_index;
+    uint64_t bit = BITMAP_BIT(local);
+    uint64_t from_bit = BITMAP_BIT(from_local);
+    bool constructed = atomic_fetch_and_explicit(&from->constructed_bitmap[BITMAP_WORD(from_local)], ~from_bit,
+                                                 memory_order_relaxed) &
+                       from_bit;
+    uint64_t old = constructed
+                       ? atomic_fetch_or_explicit(&chunk->constructed_bitmap[BITMAP_WORD(local)], bit,
+                                                  memory_order_relaxed)
+                       : atomic_fetch_and_explicit(&chunk->constructed_bitmap[BITMAP_WORD(local)], ~bit,
+                                                   memory_order_relaxed);
+    if ((old & bit) && pool->destructor)
+    {
+        pool->destructor(to, pool->hook_data);
+    }
+}
+
+// Moves up to one batch of objects out of the best compaction victim (caller holds the lock)
+static bool compact_step_locked(ObjectPool *pool, object_relocate relocate, void *user_data, size_t *moved)
+{
+    ObjectPoolChunk *victim = compaction_victim(pool);
+    size_t victim_free;
+    if (!victim || !order_free_list_locked(pool, victim, &victim_free))
+    {
+        return false;
+    }
+
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    size_t emptied[OBJECT_POOL_COMPACT_BATCH];
+    size_t moves = 0;
+    size_t local = chunk_find(victim, 0, true);
+    while (local < victim->count && moves < OBJECT_POOL_COMPACT_BATCH && available > victim_free)
+    {
+        size_t target = pool->free_list[--available];
+        char *from = victim->memory + local * pool->stride;
+        void *to = acquire_slot(pool, target);
+        move_constructed(pool, victim, local, target, to);
+        memcpy(to, from, pool->object_size);
+        relocate(from, to, user_data);
+        release_slot(pool, from, &emptied[moves++]);
+        local = chunk_find(victim, local + 1, true);
+    }
+
+    // Emptied slots go to the bottom of the free list so acquirers keep filling the dense chunks
+    memmove(pool->free_list + moves, pool->free_list, available * sizeof(size_t));
+    memcpy(pool->free_list, emptied, moves * sizeof(size_t));
+    atomic_store_explicit(&pool->available, available + moves, memory_order_relaxed);
+    pool->relocation_count += moves;
+    *moved += moves;
+
+    if (local >= victim->count)
+    {
+        release_chunk_locked(pool, victim);
+        LOG_INFO("Object pool compacted to %zu objects.", current_size(pool));
+    }
+    return true;
+}
+
+// Moves live objects out of sparse grown chunks and frees the chunks, within a time budget
+size_t object_pool_compact(ObjectPool *pool, object_relocate relocate, void *user_data, unsigned budget_us)
+{
+    if (!pool || !relocate)
+    {
+        LOG_ERROR("object_pool_compact received NULL pool or relocate callback.");
+        return 0;
+    }
+
+    if (pool->mode != OBJECT_POOL_MODE_MUTEX || pool->thread_cache_size > 0)
+    {
+        LOG_WARNING("object_pool_compact requires mutex mode without thread caches.");
+        return 0;
+    }
+
+    uint64_t deadline = budget_us > 0 ? monotonic_ns() + (uint64_t)budget_us * 1000 : UINT64_MAX;
+    size_t moved = 0;
+    bool progress;
+    // At least one step runs, however small the budget
+    do
+    {
+        // retire_lock keeps objects from being retired while they might be moved
+        pthread_mutex_lock(&pool->retire_lock);
+        pool_lock(pool);
+        if (pool->retired_count > 0 || pool->active_snapshots > 0)
+        {
+            LOG_WARNING("Compaction skipped while objects await reclamation or a snapshot is walked.");
+            progress = false;
+        }
+        else
+        {
+            progress = compact_step_locked(pool, relocate, user_data, &moved);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        pthread_mutex_unlock(&pool->retire_lock);
+    } while (progress && monotonic_ns() < deadline);
+    return moved;
+}
+
+// Helper function to unlink a cache from the pool registry (caller holds the lock)
+static void thread_cache_unregister_locked(ObjectPool *pool, ObjectPoolThreadCache *cache)
+{
+    if (cache->prev)
+    {
+        cache->prev->next = cache->next;
+    }
+    else
+    {
+        pool->thread_caches = cache->next;
+    }
+    if (cache->next)
+    {
+        cache->next->prev = cache->prev;
+    }
+}
+
+// Returns the calling thread's cache, creating and registering it on first use
+static ObjectPoolThreadCache *thread_cache_get(ObjectPool *pool)
+{
+    ObjectPoolThreadCache *cache = pthread_getspecific(pool->thread_cache_key);
+    if (cache)
+    {
+        return cache;
+    }
+
+    // Round up to whole cache lines so neighbouring caches never share one
+    size_t bytes = sizeof(ObjectPoolThreadCache) + pool->thread_cache_size * sizeof(size_t);
+    bytes = (bytes + 63) & ~(size_t)63;
+    cache = aligned_alloc(64, bytes);
+    if (!cache)
+    {
+        LOG_ERROR("Failed to allocate thread cache.");
+        return NULL;
+    }
+    cache->pool = pool;
+    cache->prev = NULL;
+    cache->count = 0;
+
+    if (pthread_setspecific(pool->thread_cache_key, cache) != 0)
+    {
+        LOG_ERROR("Failed to register thread cache.");
+        free(cache);
+        return NULL;
+    }
+
+    pool_lock(pool);
+    cache->next = pool->thread_caches;
+    if (cache->next)
+    {
+        cache->next->prev = cache;
+    }
+    pool->thread_caches = cache;
+    pthread_mutex_unlock(&pool->lock);
+    return cache;
+}
+
+// Flushes and frees a thread's cache when the thread exits
+static void thread_cache_destructor(void *arg)
+{
+    ObjectPoolThreadCache *cache = (ObjectPoolThreadCache *)arg;
+    ObjectPool *pool = cache->pool;
+
+    shared_push(pool, cache->slots, cache->count);
+    wake_waiters(pool, cache->count);
+    pool_lock(pool);
+    thread_cache_unregister_locked(pool, cache);
+    pthread_mutex_unlock(&pool->lock);
+    free(cache);
+}
+
+// Returns the calling thread's cached objects to the shared pool
+void object_pool_thread_cache_flush(ObjectPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_thread_cache_flush received NULL pool pointer.");
+        return;
+    }
+
+    if (pool->thread_cache_size == 0)
+    {
+        return;
+    }
+
+    ObjectPoolThreadCache *cache = pthread_getspecific(pool->thread_cache_key);
+    if (!cache)
+    {
+        return;
+    }
+
+    pthread_setspecific(pool->thread_cache_key, NULL);
+    thread_cache_destructor(cache);
+}
+
+// Acquires an object through the calling thread's cache
+static void *thread_cache_acquire(ObjectPool *pool)
+{
+    ObjectPoolThreadCache *cache = thread_cache_get(pool);
+    if (!cache)
+    {
+        return NULL;
+    }
+
+    if (cache->count == 0)
+    {
+        size_t batch = (pool->thread_cache_size + 1) / 2;
+        cache->count = shared_pop(pool, cache->slots, batch);
+        while (cache->count == 0 && grow(pool))
+        {
+            cache->count = shared_pop(pool, cache->slots, batch);
+        }
+        if (cache->count == 0)
+        {
+            LOG_WARNING("Object pool is empty. Cannot acquire object.");
+            return NULL;
+        }
+    }
+
+    return acquire_slot(pool, cache->slots[--cache->count]);
+}
+
+// Releases an object through the calling thread's cache; published counts objects spilled to the shared list
+static bool thread_cache_release(ObjectPool *pool, void *obj, size_t *published)
+{
+    *published = 0;
+    ObjectPoolThreadCache *cache = thread_cache_get(pool);
+    if (!cache)
+    {
+        return false;
+    }
+
+    size_t index;
+    if (!release_slot(pool, obj, &index))
+    {
+        return false;
+    }
+
+    if (cache->count == pool->thread_cache_size)
+    {
+        size_t batch = (pool->thread_cache_size + 1) / 2;
+        cache->count -= batch;
+        shared_push(pool, cache->slots + cache->count, batch);
+        *published = batch;
+    }
+
+    cache->slots[cache->count++] = index;
+    return true;
+}
+
+// Helper function to acquire one object through the pool's configured path
+static void *acquire_one(ObjectPool *pool)
+{
+    if (pool->thread_cache_size > 0)
+    {
+        return thread_cache_acquire(pool);
+    }
+
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        uint32_t index = lock_free_pop(pool);
+        while (index == LF_NIL && grow(pool))
+        {
+            index = lock_free_pop(pool);
+        }
+        if (index == LF_NIL)
+        {
+            LOG_WARNING("Object pool is empty. Cannot acquire object.");
+            return NULL;
+        }
+        return acquire_slot(pool, index);
+    }
+
+    pool_lock(pool);
+    if (atomic_load_explicit(&pool->available, memory_order_relaxed) == 0 && !grow_locked(pool))
+    {
+        pthread_mutex_unlock(&pool->lock);
+        LOG_WARNING("Object pool is empty. Cannot acquire object.");
+        return NULL;
+    }
+
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    size_t index = pool->free_list[--available];
+    atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+    note_high_water(pool, available);
+    void *obj = acquire_slot(pool, index);
+    pthread_mutex_unlock(&pool->lock);
+    LOG_INFO("Object acquired. %zu objects remaining.", available);
+    return obj;
+}
+
+// Helper function to decide whether the calling thread times this acquire
+static inline bool latency_sample_due(void)
+{
+#if OBJECT_POOL_LATENCY_SAMPLE_INTERVAL > 0
+    static _Thread_local unsigned countdown = 0;
+    if (countdown == 0)
+    {
+        countdown = OBJECT_POOL_LATENCY_SAMPLE_INTERVAL - 1;
+        return true;
+    }
+    countdown--;
+#endif
+    return false;
+}
+
+// Helper function to add a latency sample to the power-of-two histogram
+static void record_latency(ObjectPoolStatStripe *stripe, uint64_t ns)
+{
+    size_t bucket = ns == 0 ? 0 : 64 - (size_t)__builtin_clzll(ns);
+    if (bucket >= OBJECT_POOL_LATENCY_BUCKETS)
+    {
+        bucket = OBJECT_POOL_LATENCY_BUCKETS - 1;
+    }
+    stat_add(&stripe->acquire_latency[bucket], 1);
+}
+
+// Helper function to construct a freshly acquired object the first time its slot is used
+static bool construct_object(ObjectPool *pool, void *obj)
+{
+    size_t local;
+    ObjectPoolChunk *chunk = chunk_for_object(pool, obj, &local);
+    OBJECT_POOL_ATOMIC(uint64_t) *word = &chunk->constructed_bitmap[BITMAP_WORD(local)];
+    if (atomic_load_explicit(word, memory_order_relaxed) & BITMAP_BIT(local))
+    {
+        return true;
+    }
+
+    if (pool->constructor && !pool->constructor(obj, pool->hook_data))
+    {
+        LOG_WARNING("Object constructor failed.");
+        return false;
+    }
+    atomic_fetch_or_explicit(word, BITMAP_BIT(local), memory_order_relaxed);
+    return true;
+}
+
+// Helper function to run the reset hook on an object that is about to be released
+static void reset_object(ObjectPool *pool, void *obj)
+{
+    // Only reset objects that are really acquired; the release itself reports the rest
+    size_t local;
+    ObjectPoolChunk *chunk = chunk_for_object(pool, obj, &local);
+    if (chunk && (atomic_load_explicit(&chunk->acquired_bitmap[BITMAP_WORD(local)], memory_order_relaxed) &
+                  BITMAP_BIT(local)))
+    {
+        pool->reset(obj, pool->hook_data);
+    }
+}
+
+// Helper function to construct and count an object returned by one of the acquire entry points
+static void *finish_acquire(ObjectPool *pool, ObjectPoolStatStripe *stripe, void *obj)
+{
+    if (obj && tracks_construction(pool) && !construct_object(pool, obj))
+    {
+        size_t published;
+        if (release_one(pool, obj, &published))
+        {
+            wake_waiters(pool, published);
+        }
+        obj = NULL;
+    }
+
+    stat_add(obj ? &stripe->acquires : &stripe->failed_acquires, 1);
+    return obj;
+}
+
+// Acquires an object from the pool
+void *object_pool_acquire(ObjectPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_acquire received NULL pool pointer.");
+        return NULL;
+    }
+
+    ObjectPoolStatStripe *stripe = stat_stripe(pool);
+    void *obj;
+    if (latency_sample_due())
+    {
+        uint64_t start = monotonic_ns();
+        obj = acquire_one(pool);
+        record_latency(stripe, monotonic_ns() - start);
+    }
+    else
+    {
+        obj = acquire_one(pool);
+    }
+
+    return finish_acquire(pool, stripe, obj);
+}
+
+// Helper function to release one object through the pool's configured path; published counts
+// the objects that reached the shared free list, which is all a waiter can take
+static bool release_one(ObjectPool *pool, void *obj, size_t *published)
+{
+    if (pool->thread_cache_size > 0)
+    {
+        return thread_cache_release(pool, obj, published);
+    }
+
+    *published = 1;
+
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        // Clearing the acquired bit first makes a second release of the same slot fail
+        size_t index;
+        if (!release_slot(pool, obj, &index))
+        {
+            return false;
+        }
+        lock_free_push(pool, (uint32_t)index);
+        return true;
+    }
+
+    pool_lock(pool);
+    size_t index;
+    if (!release_slot(pool, obj, &index))
+    {
+        pthread_mutex_unlock(&pool->lock);
+        return false;
+    }
+
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    pool->free_list[available++] = index;
+    atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+    if (pool->idle_shrink_ms > 0)
+    {
+        shrink_idle_locked(pool);
+        available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    LOG_INFO("Object released. %zu objects available.", available);
+    return true;
+}
+
+// Releases an object back to the pool
+void object_pool_release(ObjectPool *pool, void *obj)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_release received NULL pool pointer.");
+        return;
+    }
+
+    if (!obj)
+    {
+        LOG_WARNING("Attempted to release a NULL object.");
+        return;
+    }
+
+    if (pool->reset)
+    {
+        reset_object(pool, obj);
+    }
+
+    size_t published;
+    if (release_one(pool, obj, &published))
+    {
+        stat_add(&stat_stripe(pool)->releases, 1);
+        wake_waiters(pool, published);
+    }
+}
+
+// Helper function to unlink a waiter that gave up before being woken (caller holds wait_lock)
+static void remove_waiter_locked(ObjectPool *pool, ObjectPoolWaiter *waiter)
+{
+    ObjectPoolWaiter **link = &pool->wait_head;
+    ObjectPoolWaiter *prev = NULL;
+    while (*link && *link != waiter)
+    {
+        prev = *link;
+        link = &(*link)->next;
+    }
+    if (*link)
+    {
+        *link = waiter->next;
+        if (pool->wait_tail == waiter)
+        {
+            pool->wait_tail = prev;
+        }
+        atomic_fetch_sub(&pool->waiter_count, 1);
+    }
+}
+
+// Wakes up to count waiters after objects reached the shared free list
+static void wake_waiters(ObjectPool *pool, size_t count)
+{
+    // Pairs with the fence in acquire_blocking: either the waiter's retry sees
+    // the freed object or this load sees the waiter
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&pool->waiter_count, memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    // Lock order is wait_lock before the pool lock: the FIFO branch pops under wait_lock,
+    // so no caller may hold the pool lock here
+    pthread_mutex_lock(&pool->wait_lock);
+    while (count > 0 && pool->wait_head)
+    {
+        ObjectPoolWaiter *waiter = pool->wait_head;
+        if (pool->wait_fifo)
+        {
+            // Take the object for the oldest waiter so late arrivals cannot overtake it
+            size_t index;
+            if (shared_pop(pool, &index, 1) == 0)
+            {
+                break;
+            }
+            waiter->object = acquire_slot(pool, index);
+        }
+
+        pool->wait_head = waiter->next;
+        if (!pool->wait_head)
+        {
+            pool->wait_tail = NULL;
+        }
+        atomic_fetch_sub(&pool->waiter_count, 1);
+        waiter->signaled = true;
+        pthread_cond_signal(&waiter->cond);
+        count--;
+    }
+    pthread_mutex_unlock(&pool->wait_lock);
+}
+
+// Acquires an object, parking the caller until one is released or the deadline passes
+static void *acquire_blocking(ObjectPool *pool, const struct timespec *deadline)
+{
+    ObjectPoolStatStripe *stripe = stat_stripe(pool);
+    for (;;)
+    {
+        void *obj = acquire_one(pool);
+        if (obj)
+        {
+            return finish_acquire(pool, stripe, obj);
+        }
+
+        ObjectPoolWaiter waiter = {.signaled = false, .object = NULL, .next = NULL};
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&waiter.cond, &attr);
+        pthread_condattr_destroy(&attr);
+
+        pthread_mutex_lock(&pool->wait_lock);
+        if (pool->wait_tail)
+        {
+            pool->wait_tail->next = &waiter;
+        }
+        else
+        {
+            pool->wait_head = &waiter;
+        }
+        pool->wait_tail = &waiter;
+        atomic_fetch_add(&pool->waiter_count, 1);
+        pthread_mutex_unlock(&pool->wait_lock);
+
+        // Retry once registered so a release racing with the first attempt is not missed
+        atomic_thread_fence(memory_order_seq_cst);
+        obj = acquire_one(pool);
+
+        bool timed_out = false;
+        pthread_mutex_lock(&pool->wait_lock);
+        while (!obj && !waiter.signaled && !timed_out)
+        {
+            if (deadline)
+            {
+                timed_out = pthread_cond_timedwait(&waiter.cond, &pool->wait_lock, deadline) == ETIMEDOUT;
+            }
+            else
+            {
+                pthread_cond_wait(&waiter.cond, &pool->wait_lock);
+            }
+        }
+        if (!waiter.signaled)
+        {
+            remove_waiter_locked(pool, &waiter);
+        }
+        pthread_mutex_unlock(&pool->wait_lock);
+        pthread_cond_destroy(&waiter.cond);
+
+        // The retry and a direct handoff can both succeed; keep one and pass the other on
+        if (obj && waiter.object)
+        {
+            size_t published;
+            if (release_one(pool, waiter.object, &published))
+            {
+                wake_waiters(pool, published);
+            }
+        }
+        else if (waiter.object)
+        {
+            obj = waiter.object;
+        }
+
+        if (obj)
+        {
+            return finish_acquire(pool, stripe, obj);
+        }
+        if (timed_out)
+        {
+            return finish_acquire(pool, stripe, NULL);
+        }
+    }
+}
+
+// Acquires an object, waiting as long as it takes for one to be released
+void *object_pool_acquire_wait(ObjectPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_acquire_wait received NULL pool pointer.");
+        return NULL;
+    }
+    return acquire_blocking(pool, NULL);
+}
+
+// Acquires an object, waiting at most timeout_ms for one to be released
+void *object_pool_acquire_timed(ObjectPool *pool, unsigned timeout_ms)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_acquire_timed received NULL pool pointer.");
+        return NULL;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    return acquire_blocking(pool, &deadline);
+}
+
+// Acquires up to count objects from the shared free list, growing the pool as needed
+static size_t shared_acquire_n(ObjectPool *pool, void **objects, size_t count)
+{
+    size_t acquired = 0;
+
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        while (acquired < count)
+        {
+            uint32_t index;
+            size_t taken = lock_free_pop_chain(pool, count - acquired, &index);
+            if (taken == 0)
+            {
+                if (grow(pool))
+                {
+                    continue;
+                }
+                break;
+            }
+
+            // The popped chain belongs to this thread, so its links are stable
+            for (size_t i = 0; i < taken; i++)
+            {
+                uint32_t next = atomic_load_explicit(free_next_of(pool, index), memory_order_relaxed);
+                objects[acquired++] = acquire_slot(pool, index);
+                index = next;
+            }
+        }
+        return acquired;
+    }
+
+    pool_lock(pool);
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    while (acquired < count)
+    {
+        if (available == 0)
+        {
+            atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+            if (!grow_locked(pool))
+            {
+                break;
+            }
+            available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+        }
+        objects[acquired++] = acquire_slot(pool, pool->free_list[--available]);
+    }
+    atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+    note_high_water(pool, available);
+    pthread_mutex_unlock(&pool->lock);
+    return acquired;
+}
+
+// Validates count objects and returns them to the shared free list
+static size_t shared_release_n(ObjectPool *pool, void *const *objects, size_t count)
+{
+    size_t released = 0;
+    size_t index;
+
+    if (pool->mode == OBJECT_POOL_MODE_LOCK_FREE)
+    {
+        // Link the valid objects into a private chain and push it with one CAS
+        uint32_t first = LF_NIL;
+        uint32_t last = LF_NIL;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!objects[i] || !release_slot(pool, objects[i], &index))
+            {
+                continue;
+            }
+            atomic_store_explicit(free_next_of(pool, (uint32_t)index), first, memory_order_relaxed);
+            if (last == LF_NIL)
+            {
+                last = (uint32_t)index;
+            }
+            first = (uint32_t)index;
+            released++;
+        }
+        if (released > 0)
+        {
+            lock_free_push_chain(pool, first, last, released);
+        }
+        return released;
+    }
+
+    pool_lock(pool);
+    size_t available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (objects[i] && release_slot(pool, objects[i], &index))
+        {
+            pool->free_list[available++] = index;
+            released++;
+        }
+    }
+    atomic_store_explicit(&pool->available, available, memory_order_relaxed);
+    if (pool->idle_shrink_ms > 0)
+    {
+        shrink_idle_locked(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return released;
+}
+
+// Acquires up to count objects at once
+size_t object_pool_acquire_n(ObjectPool *pool, void **objects, size_t count)
+{
+    if (!pool || !objects)
+    {
+        LOG_ERROR("object_pool_acquire_n received NULL pool or objects pointer.");
+        return 0;
+    }
+
+    size_t acquired = 0;
+    if (pool->thread_cache_size > 0)
+    {
+        ObjectPoolThreadCache *cache = thread_cache_get(pool);
+        if (!cache)
+        {
+            return 0;
+        }
+        while (acquired < count && cache->count > 0)
+        {
+            objects[acquired++] = acquire_slot(pool, cache->slots[--cache->count]);
+        }
+    }
+
+    if (acquired < count)
+    {
+        acquired += shared_acquire_n(pool, objects + acquired, count - acquired);
+    }
+
+    // Objects whose constructor fails go straight back and the rest close ranks
+    if (tracks_construction(pool))
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < acquired; i++)
+        {
+            if (construct_object(pool, objects[i]))
+            {
+                objects[kept++] = objects[i];
+            }
+            else
+            {
+                size_t published;
+                if (release_one(pool, objects[i], &published))
+                {
+                    wake_waiters(pool, published);
+                }
+            }
+        }
+        acquired = kept;
+    }
+
+    ObjectPoolStatStripe *stripe = stat_stripe(pool);
+    stat_add(&stripe->acquires, acquired);
+    if (acquired < count)
+    {
+        stat_add(&stripe->failed_acquires, count - acquired);
+        LOG_WARNING("Object pool is empty. Acquired %zu of %zu objects.", acquired, count);
+    }
+    else if (pool->mode == OBJECT_POOL_MODE_MUTEX && pool->thread_cache_size == 0)
+    {
+        LOG_INFO("Acquired %zu objects. %zu objects remaining.", acquired, (size_t)pool->available);
+    }
+    return acquired;
+}
+
+// Releases count objects at once
+size_t object_pool_release_n(ObjectPool *pool, void *const *objects, size_t count)
+{
+    if (!pool || !objects)
+    {
+        LOG_ERROR("object_pool_release_n received NULL pool or objects pointer.");
+        return 0;
+    }
+
+    if (pool->reset)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (objects[i])
+            {
+                reset_object(pool, objects[i]);
+            }
+        }
+    }
+
+    size_t released = 0;
+    size_t index;
+    size_t i = 0;
+    if (pool->thread_cache_size > 0)
+    {
+        ObjectPoolThreadCache *cache = thread_cache_get(pool);
+        if (!cache)
+        {
+            return 0;
+        }
+        for (; i < count && cache->count < pool->thread_cache_size; i++)
+        {
+            if (objects[i] && release_slot(pool, objects[i], &index))
+            {
+                cache->slots[cache->count++] = index;
+                released++;
+            }
+        }
+    }
+
+    // Objects kept in the cache are invisible to other threads, so only the shared ones wake waiters
+    size_t published = shared_release_n(pool, objects + i, count - i);
+    released += published;
+    stat_add(&stat_stripe(pool)->releases, released);
+    wake_waiters(pool, published);
+
+    if (pool->mode == OBJECT_POOL_MODE_MUTEX && pool->thread_cache_size == 0)
+    {
+        LOG_INFO("Released %zu objects. %zu objects available.", released, (size_t)pool->available);
+    }
+    return released;
+}
+
+// Returns the pool-wide slot index of an object
+size_t object_pool_index_of(ObjectPool *pool, const void *obj)
+{
+    size_t local;
+    ObjectPoolChunk *chunk = pool && obj ? chunk_for_object(pool, obj, &local) : NULL;
+    return chunk ? chunk->first_index + local : OBJECT_POOL_INVALID_INDEX;
+}
+
+// Returns the object in a slot
+void *object_pool_at(ObjectPool *pool, size_t index)
+{
+    if (!pool || index == OBJECT_POOL_INVALID_INDEX)
+    {
+        return NULL;
+    }
+
+    ObjectPoolChunk *chunk = chunk_for_index(pool, index);
+    size_t local = index - chunk->first_index;
+    if (local >= chunk->count || !chunk->memory)
+    {
+        return NULL;
+    }
+    return chunk->memory + local * pool->stride;
+}
+
+// Acquires an object and returns a handle to it
+ObjectPoolHandle object_pool_acquire_handle(ObjectPool *pool)
+{
+    if (!pool || !pool->handles)
+    {
+        LOG_ERROR("object_pool_acquire_handle requires a pool initialized with handles.");
+        return OBJECT_POOL_NULL_HANDLE;
+    }
+
+    void *obj = object_pool_acquire(pool);
+    if (!obj)
+    {
+        return OBJECT_POOL_NULL_HANDLE;
+    }
+
+    ObjectPoolHandle handle = object_pool_handle_of(pool, obj);
+    if (handle == OBJECT_POOL_NULL_HANDLE)
+    {
+        object_pool_release(pool, obj);
+    }
+    return handle;
+}
+
+// Returns the handle of an acquired object
+ObjectPoolHandle object_pool_handle_of(ObjectPool *pool, const void *obj)
+{
+    size_t local;
+    ObjectPoolChunk *chunk = pool && pool->handles && obj ? chunk_for_object(pool, obj, &local) : NULL;
+    if (!chunk ||
+        !(atomic_load_explicit(&chunk->acquired_bitmap[BITMAP_WORD(local)], memory_order_relaxed) & BITMAP_BIT(local)))
+    {
+        LOG_WARNING("Attempted to take a handle to an object not acquired from the pool.");
+        return OBJECT_POOL_NULL_HANDLE;
+    }
+
+    size_t index = chunk->first_index + local;
+    if (index > HANDLE_INDEX_MASK)
+    {
+        LOG_ERROR("Slot %zu is beyond the %d-bit handle index range.", index, OBJECT_POOL_HANDLE_INDEX_BITS);
+        return OBJECT_POOL_NULL_HANDLE;
+    }
+    return HANDLE(index, atomic_load_explicit(&chunk->generations[local], memory_order_relaxed));
+}
+
+// Resolves a handle to its object, or NULL if it is stale
+void *object_pool_resolve(ObjectPool *pool, ObjectPoolHandle handle)
+{
+    if (!pool || !pool->handles || handle == OBJECT_POOL_NULL_HANDLE)
+    {
+        return NULL;
+    }
+
+    size_t index = handle & HANDLE_INDEX_MASK;
+    ObjectPoolChunk *chunk = chunk_for_index(pool, index);
+    size_t local = index - chunk->first_index;
+    if (local >= chunk->count || !chunk->memory)
+    {
+        return NULL;
+    }
+
+    // The generation moves on after the acquired bit clears, so checking both closes the gap in between
+    uint32_t releases = atomic_load_explicit(&chunk->generations[local], memory_order_acquire);
+    if (HANDLE(index, releases) != handle ||
+        !(atomic_load_explicit(&chunk->acquired_bitmap[BITMAP_WORD(local)], memory_order_relaxed) & BITMAP_BIT(local)))
+    {
+        return NULL;
+    }
+    return chunk->memory + local * pool->stride;
+}
+
+// Releases the object a handle refers to
+bool object_pool_release_handle(ObjectPool *pool, ObjectPoolHandle handle)
+{
+    void *obj = object_pool_resolve(pool, handle);
+    if (!obj)
+    {
+        LOG_WARNING("Attempted to release through a stale or null handle.");
+        return false;
+    }
+
+    // A concurrent release through the same handle can get in first; only one of them succeeds
+    return object_pool_release_n(pool, &obj, 1) == 1;
+}
+
+// Helper function to walk the acquired bitmaps, skipping empty words
+static size_t for_each_acquired(ObjectPool *pool, object_callback callback, void *user_data)
+{
+    size_t found = 0;
+    size_t count = atomic_load_explicit(&pool->chunk_count, memory_order_acquire);
+    for (size_t i = 0; i < count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        size_t words = BITMAP_WORDS(chunk->count);
+        for (size_t word = scan_bitmap(chunk->acquired_bitmap, 0, words, 0); word < words;
+             word = scan_bitmap(chunk->acquired_bitmap, word + 1, words, 0))
+        {
+            uint64_t bits = atomic_load_explicit(&chunk->acquired_bitmap[word], memory_order_relaxed);
+            while (bits)
+            {
+                size_t local = word * 64 + (size_t)__builtin_ctzll(bits);
+                if (callback)
+                {
+                    callback(chunk->memory + local * pool->stride, user_data);
+                }
+                bits &= bits - 1;
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+// Iterates over all acquired objects and applies a callback function
+void object_pool_iterate_acquired(ObjectPool *pool, object_callback callback, void *user_data)
+{
+    if (!pool || !callback)
+    {
+        LOG_ERROR("object_pool_iterate_acquired received NULL pool or callback.");
+        return;
+    }
+
+    // Mutex-mode bitmap updates happen under the lock, so holding it keeps the walk consistent
+    bool locked = pool->mode == OBJECT_POOL_MODE_MUTEX && pool->thread_cache_size == 0;
+    if (locked)
+    {
+        pool_lock(pool);
+    }
+    for_each_acquired(pool, callback, user_data);
+    if (locked)
+    {
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// Predicate and running match count threaded through object_pool_iterate_acquired
+typedef struct
+{
+    object_predicate predicate; /**< Caller's predicate */
+    void *user_data;            /**< Caller's user data */
+    size_t matches;             /**< Objects the predicate accepted */
+} CountIfState;
+
+// Helper function to apply the caller's predicate to one acquired object
+static void count_if_visit(void *object, void *user_data)
+{
+    CountIfState *state = user_data;
+    if (state->predicate(object, state->user_data))
     {
-        log_error("Invalid parameters for object_pool_init.");
-        return false;
+        state->matches++;
+    }
+}
+
+// Counts the acquired objects that satisfy a predicate
+size_t object_pool_count_if(ObjectPool *pool, object_predicate predicate, void *user_data)
+{
+    if (!pool || !predicate)
+    {
+        LOG_ERROR("object_pool_count_if received NULL pool or predicate.");
+        return 0;
     }
 
-    ObjectPool *pool = (ObjectPool *)malloc(sizeof(ObjectPool));
+    CountIfState state = {predicate, user_data, 0};
+    object_pool_iterate_acquired(pool, count_if_visit, &state);
+    return state.matches;
+}
+
+// Finds the first slot at or after from that is not acquired
+size_t object_pool_find_free(ObjectPool *pool, size_t from)
+{
     if (!pool)
     {
-        log_error("Failed to allocate memory for ObjectPool.");
-        return false;
+        LOG_ERROR("object_pool_find_free received NULL pool pointer.");
+        return OBJECT_POOL_INVALID_INDEX;
     }
 
-    pool->memory_block = malloc(initial_size * object_size);
-    if (!pool->memory_block)
+    size_t count = atomic_load_explicit(&pool->chunk_count, memory_order_acquire);
+    for (size_t i = 0; i < count; i++)
     {
-        log_error("Failed to allocate memory for object pool.");
-        free(pool);
-        return false;
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        if (!chunk->memory || chunk->first_index + chunk->count <= from)
+        {
+            continue;
+        }
+
+        size_t local = chunk_find(chunk, from > chunk->first_index ? from - chunk->first_index : 0, false);
+        if (local < chunk->count)
+        {
+            return chunk->first_index + local;
+        }
     }
+    return OBJECT_POOL_INVALID_INDEX;
+}
 
-    pool->free_list = malloc(initial_size * sizeof(void *));
-    if (!pool->free_list)
+// Fills the free slots in a range of slot indices with a byte value
+size_t object_pool_fill_free(ObjectPool *pool, size_t first, size_t count, int value)
+{
+    if (!pool)
     {
-        log_error("Failed to allocate memory for free list.");
-        free(pool->memory_block);
-        free(pool);
-        return false;
+        LOG_ERROR("object_pool_fill_free received NULL pool pointer.");
+        return 0;
+    }
+    if (tracks_construction(pool))
+    {
+        LOG_WARNING("Free slots of a pool with constructor or destructor hooks hold live objects; not filling them.");
+        return 0;
+    }
+#ifdef OBJECT_POOL_DEBUG
+    if (debug_poisons_contents(pool))
+    {
+        LOG_WARNING("Free slots hold poison in debug builds; not filling them.");
+        return 0;
     }
+#endif
 
-    // Initialize free list
-    for (size_t i = 0; i < initial_size; i++)
+    size_t end = count > SIZE_MAX - first ? SIZE_MAX : first + count;
+    size_t filled = 0;
+    bool locked = pool->mode == OBJECT_POOL_MODE_MUTEX && pool->thread_cache_size == 0;
+    if (locked)
     {
-        pool->free_list[i] = (char *)pool->memory_block + i * object_size;
+        pool_lock(pool);
     }
 
-    pool->pool_size = initial_size;
-    pool->object_size = object_size;
-    pool->available = initial_size;
-    pool->acquired_head = NULL;
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_acquire);
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        if (!chunk->memory || chunk->first_index >= end || chunk->first_index + chunk->count <= first)
+        {
+            continue;
+        }
 
-    if (pthread_mutex_init(&pool->lock, NULL) != 0)
+        size_t local = first > chunk->first_index ? first - chunk->first_index : 0;
+        size_t limit = end - chunk->first_index < chunk->count ? end - chunk->first_index : chunk->count;
+        while (local < limit)
+        {
+            // One memset per run of free slots; libc picks its own vector width for the stores
+            size_t run = chunk_find(chunk, local, false);
+            if (run >= limit)
+            {
+                break;
+            }
+            size_t run_end = chunk_find(chunk, run + 1, true);
+            run_end = run_end < limit ? run_end : limit;
+            memset(chunk->memory + run * pool->stride, value, (run_end - run) * pool->stride);
+            filled += run_end - run;
+            local = run_end;
+        }
+    }
+
+    if (locked)
     {
-        log_error("Failed to initialize mutex.");
-        free(pool->free_list);
-        free(pool->memory_block);
-        free(pool);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return filled;
+}
+
+// Returns the name of the bitmap scan kernel selected for this CPU
+const char *object_pool_simd_kernel(void)
+{
+    pthread_once(&scan_kernel_once, select_scan_kernel);
+    return scan_kernel_name;
+}
+
+// Acquired slots of one chunk as captured by a snapshot
+typedef struct
+{
+    char *memory;      /**< Chunk memory at snapshot time */
+    size_t count;      /**< Number of slots in the chunk */
+    size_t first_word; /**< Offset of the chunk's words in the snapshot bitmap */
+} SnapshotChunk;
+
+// Copy of every chunk's acquired bitmap, walked without the pool lock
+typedef struct
+{
+    SnapshotChunk chunks[OBJECT_POOL_MAX_CHUNKS]; /**< Chunks with memory, in pool order */
+    size_t chunk_count;                           /**< Number of entries in chunks */
+    size_t word_count;                            /**< Number of bitmap words across all chunks */
+    uint64_t *words;                              /**< Copied acquired bitmaps */
+} AcquiredSnapshot;
+
+// Helper function to copy the acquired bitmaps under the lock and pin chunk memory
+static bool take_snapshot(ObjectPool *pool, AcquiredSnapshot *snapshot)
+{
+    pool_lock(pool);
+    size_t chunk_count = atomic_load_explicit(&pool->chunk_count, memory_order_relaxed);
+    size_t word_count = 0;
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        word_count += BITMAP_WORDS(pool->chunks[i].count);
+    }
+
+    snapshot->words = malloc(word_count * sizeof(uint64_t));
+    if (!snapshot->words)
+    {
+        pthread_mutex_unlock(&pool->lock);
+        LOG_ERROR("Failed to allocate memory for the acquired snapshot.");
         return false;
     }
 
-    log_info("Object pool initialized with %zu objects.", initial_size);
-    *pool_ptr = pool;
+    snapshot->chunk_count = 0;
+    snapshot->word_count = word_count;
+    size_t word = 0;
+    for (size_t i = 0; i < chunk_count; i++)
+    {
+        ObjectPoolChunk *chunk = &pool->chunks[i];
+        size_t words = BITMAP_WORDS(chunk->count);
+        if (chunk->memory)
+        {
+            SnapshotChunk *copy = &snapshot->chunks[snapshot->chunk_count++];
+            copy->memory = chunk->memory;
+            copy->count = chunk->count;
+            copy->first_word = word;
+        }
+        for (size_t w = 0; w < words; w++)
+        {
+            snapshot->words[word++] = chunk->memory ? atomic_load_explicit(&chunk->acquired_bitmap[w],
+                                                                           memory_order_relaxed)
+                                                    : 0;
+        }
+    }
+
+    // Idle shrinking stays off until the callbacks are done with the snapshot's chunks
+    pool->active_snapshots++;
+    pthread_mutex_unlock(&pool->lock);
     return true;
 }
 
-// Helper function to add a node to the acquired list
-static void add_acquired_node(ObjectPool *pool, void *obj)
+// Helper function to unpin chunk memory and free a snapshot
+static void drop_snapshot(ObjectPool *pool, AcquiredSnapshot *snapshot)
 {
-    AcquiredNode *node = (AcquiredNode *)malloc(sizeof(AcquiredNode));
-    if (!node)
+    pool_lock(pool);
+    pool->active_snapshots--;
+    pthread_mutex_unlock(&pool->lock);
+    free(snapshot->words);
+}
+
+// Helper function to run the callback on the snapshot's objects in words [begin, end)
+static size_t visit_snapshot(ObjectPool *pool, const AcquiredSnapshot *snapshot, size_t begin, size_t end,
+                             object_callback callback, void *user_data)
+{
+    size_t visited = 0;
+    for (size_t i = 0; i < snapshot->chunk_count; i++)
     {
-        log_error("Failed to allocate memory for AcquiredNode.");
-        return;
+        const SnapshotChunk *chunk = &snapshot->chunks[i];
+        size_t first = chunk->first_word > begin ? chunk->first_word : begin;
+        size_t last = chunk->first_word + BITMAP_WORDS(chunk->count);
+        last = last < end ? last : end;
+        for (size_t word = scan_words(snapshot->words, first, last, 0); word < last;
+             word = scan_words(snapshot->words, word + 1, last, 0))
+        {
+            uint64_t bits = snapshot->words[word];
+            while (bits)
+            {
+                size_t local = (word - chunk->first_word) * 64 + (size_t)__builtin_ctzll(bits);
+                callback(chunk->memory + local * pool->stride, user_data);
+                bits &= bits - 1;
+                visited++;
+            }
+        }
+    }
+    return visited;
+}
+
+// Iterates over a snapshot of the acquired objects with the callbacks outside the lock
+size_t object_pool_iterate_snapshot(ObjectPool *pool, object_callback callback, void *user_data)
+{
+    if (!pool || !callback)
+    {
+        LOG_ERROR("object_pool_iterate_snapshot received NULL pool or callback.");
+        return 0;
+    }
+
+    AcquiredSnapshot snapshot;
+    if (!take_snapshot(pool, &snapshot))
+    {
+        return 0;
     }
-    node->object = obj;
-    node->next = pool->acquired_head;
-    pool->acquired_head = node;
+    size_t visited = visit_snapshot(pool, &snapshot, 0, snapshot.word_count, callback, user_data);
+    drop_snapshot(pool, &snapshot);
+    return visited;
+}
+
+// Work assigned to one thread of a parallel snapshot walk
+typedef struct
+{
+    ObjectPool *pool;
+    const AcquiredSnapshot *snapshot;
+    size_t begin;
+    size_t end;
+    object_callback callback;
+    void *user_data;
+    size_t visited;
+    pthread_t thread;
+    bool started;
+} SnapshotWorker;
+
+// Helper function run by each thread of a parallel snapshot walk
+static void *snapshot_worker(void *arg)
+{
+    SnapshotWorker *worker = arg;
+    worker->visited = visit_snapshot(worker->pool, worker->snapshot, worker->begin, worker->end,
+                                     worker->callback, worker->user_data);
+    return NULL;
 }
 
-// Helper function to remove a node from the acquired list
-static int remove_acquired_node(ObjectPool *pool, void *obj)
+// Iterates over a snapshot of the acquired objects, splitting the bitmap across threads
+size_t object_pool_iterate_parallel(ObjectPool *pool, object_callback callback, void *user_data,
+                                    size_t thread_count)
 {
-    AcquiredNode *current = pool->acquired_head;
-    AcquiredNode *prev = NULL;
+    if (!pool || !callback)
+    {
+        LOG_ERROR("object_pool_iterate_parallel received NULL pool or callback.");
+        return 0;
+    }
+
+    if (thread_count == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cpus > 0 ? (size_t)cpus : 1;
+    }
+
+    AcquiredSnapshot snapshot;
+    if (!take_snapshot(pool, &snapshot))
+    {
+        return 0;
+    }
 
-    while (current)
+    // Every thread gets at least one bitmap word (64 slots)
+    if (thread_count > snapshot.word_count)
+    {
+        thread_count = snapshot.word_count > 0 ? snapshot.word_count : 1;
+    }
+
+    SnapshotWorker *workers = calloc(thread_count, sizeof(SnapshotWorker));
+    if (!workers)
+    {
+        LOG_WARNING("Failed to allocate parallel iteration workers; iterating serially.");
+        thread_count = 0;
+    }
+
+    size_t visited = 0;
+    if (thread_count <= 1)
+    {
+        visited = visit_snapshot(pool, &snapshot, 0, snapshot.word_count, callback, user_data);
+    }
+    else
     {
-        if (current->object == obj)
+        size_t per_thread = snapshot.word_count / thread_count;
+        size_t extra = snapshot.word_count % thread_count;
+        size_t begin = 0;
+        for (size_t t = 0; t < thread_count; t++)
         {
-            if (prev)
+            SnapshotWorker *worker = &workers[t];
+            worker->pool = pool;
+            worker->snapshot = &snapshot;
+            worker->begin = begin;
+            worker->end = begin + per_thread + (t < extra ? 1 : 0);
+            worker->callback = callback;
+            worker->user_data = user_data;
+            begin = worker->end;
+
+            // The calling thread takes the first range; a thread that fails to start is run inline
+            if (t > 0)
             {
-                prev->next = current->next;
+                worker->started = pthread_create(&worker->thread, NULL, snapshot_worker, worker) == 0;
             }
-            else
+        }
+
+        snapshot_worker(&workers[0]);
+        for (size_t t = 0; t < thread_count; t++)
+        {
+            if (workers[t].started)
+            {
+                pthread_join(workers[t].thread, NULL);
+            }
+            else if (t > 0)
             {
-                pool->acquired_head = current->next;
+                snapshot_worker(&workers[t]);
             }
-            free(current);
-            return 1; // Successfully removed
+            visited += workers[t].visited;
         }
-        prev = current;
-        current = current->next;
     }
-    return 0; // Object not found
+
+    free(workers);
+    drop_snapshot(pool, &snapshot);
+    return visited;
 }
 
-// Acquires an object from the pool
-void *object_pool_acquire(ObjectPool *pool)
+// Helper function to mark a reader record free when its thread exits
+static void epoch_record_destructor(void *arg)
 {
-    if (!pool)
+    ObjectPoolEpochRecord *record = arg;
+    record->nesting = 0;
+    atomic_store(&record->epoch, 0);
+    atomic_store(&record->in_use, false);
+}
+
+// Helper function to get the calling thread's reader record, registering one on first use
+static ObjectPoolEpochRecord *epoch_record_get(ObjectPool *pool)
+{
+    if (atomic_load_explicit(&pool->epoch_key_ready, memory_order_acquire))
     {
-        log_error("object_pool_acquire received NULL pool pointer.");
-        return NULL;
+        ObjectPoolEpochRecord *record = pthread_getspecific(pool->epoch_key);
+        if (record)
+        {
+            return record;
+        }
     }
 
-    pthread_mutex_lock(&pool->lock);
-    if (pool->available == 0)
+    pthread_mutex_lock(&pool->retire_lock);
+    if (!atomic_load_explicit(&pool->epoch_key_ready, memory_order_relaxed))
     {
-        pthread_mutex_unlock(&pool->lock);
-        log_warning("Object pool is empty. Cannot acquire object.");
-        return NULL;
+        if (pthread_key_create(&pool->epoch_key, epoch_record_destructor) != 0)
+        {
+            pthread_mutex_unlock(&pool->retire_lock);
+            LOG_ERROR("Failed to create epoch key.");
+            return NULL;
+        }
+        atomic_store_explicit(&pool->epoch_key_ready, true, memory_order_release);
     }
 
-    void *obj = pool->free_list[--pool->available];
-    add_acquired_node(pool, obj);
-    pthread_mutex_unlock(&pool->lock);
-    log_info("Object acquired. %zu objects remaining.", pool->available);
-    return obj;
+    // Reuse a record left behind by an exited thread before allocating a new one
+    ObjectPoolEpochRecord *record = pool->epoch_records;
+    while (record)
+    {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&record->in_use, &expected, true))
+        {
+            break;
+        }
+        record = record->next;
+    }
+    if (!record)
+    {
+        record = calloc(1, sizeof(ObjectPoolEpochRecord));
+        if (record)
+        {
+            atomic_init(&record->epoch, 0);
+            atomic_init(&record->in_use, true);
+            record->next = pool->epoch_records;
+            pool->epoch_records = record;
+        }
+    }
+    pthread_mutex_unlock(&pool->retire_lock);
+
+    if (!record || pthread_setspecific(pool->epoch_key, record) != 0)
+    {
+        LOG_ERROR("Failed to register epoch reader.");
+        if (record)
+        {
+            atomic_store(&record->in_use, false);
+        }
+        return NULL;
+    }
+    return record;
 }
 
-// Releases an object back to the pool
-void object_pool_release(ObjectPool *pool, void *obj)
+// Enters a read section in which retired objects stay valid
+bool object_pool_read_lock(ObjectPool *pool)
 {
     if (!pool)
     {
-        log_error("object_pool_release received NULL pool pointer.");
+        LOG_ERROR("object_pool_read_lock received NULL pool pointer.");
+        return false;
+    }
+
+    ObjectPoolEpochRecord *record = epoch_record_get(pool);
+    if (!record)
+    {
+        return false;
+    }
+
+    if (record->nesting++ == 0)
+    {
+        // Announce the epoch before any shared pointer is loaded; pairs with the scan in try_advance_epoch
+        uint64_t epoch = atomic_load(&pool->epoch);
+        atomic_store(&record->epoch, epoch << 1 | 1);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+    return true;
+}
+
+// Leaves a read section
+void object_pool_read_unlock(ObjectPool *pool)
+{
+    if (!pool || !atomic_load_explicit(&pool->epoch_key_ready, memory_order_acquire))
+    {
+        LOG_ERROR("object_pool_read_unlock called without a matching read lock.");
         return;
     }
 
-    if (!obj)
+    ObjectPoolEpochRecord *record = pthread_getspecific(pool->epoch_key);
+    if (!record || record->nesting == 0)
     {
-        log_warning("Attempted to release a NULL object.");
+        LOG_ERROR("object_pool_read_unlock called without a matching read lock.");
         return;
     }
 
-    pthread_mutex_lock(&pool->lock);
-    if (!remove_acquired_node(pool, obj))
+    if (--record->nesting == 0)
+    {
+        atomic_store_explicit(&record->epoch, 0, memory_order_release);
+    }
+}
+
+// Helper function to advance the global epoch once every active reader has seen it (caller holds retire_lock)
+static void try_advance_epoch(ObjectPool *pool)
+{
+    uint64_t epoch = atomic_load(&pool->epoch);
+    for (ObjectPoolEpochRecord *record = pool->epoch_records; record; record = record->next)
+    {
+        uint64_t announced = atomic_load(&record->epoch);
+        if ((announced & 1) && (announced >> 1) != epoch)
+        {
+            return;
+        }
+    }
+    atomic_store(&pool->epoch, epoch + 1);
+}
+
+// Helper function to release the oldest count retired objects (caller holds retire_lock)
+static void release_retired(ObjectPool *pool, size_t count)
+{
+    if (count == 0)
     {
-        log_warning("Attempted to release an object not acquired from the pool.");
-        pthread_mutex_unlock(&pool->lock);
         return;
     }
 
-    pool->free_list[pool->available++] = obj;
-    pthread_mutex_unlock(&pool->lock);
-    log_info("Object released. %zu objects available.", pool->available);
+    object_pool_release_n(pool, pool->retired, count);
+    pool->retired_count -= count;
+    memmove(pool->retired, pool->retired + count, pool->retired_count * sizeof(void *));
+    memmove(pool->retired_epochs, pool->retired_epochs + count, pool->retired_count * sizeof(uint64_t));
 }
 
-// Iterates over all acquired objects and applies a callback function
-void object_pool_iterate_acquired(ObjectPool *pool, object_callback callback, void *user_data)
+// Helper function to release every retired object whose grace period has passed (caller holds retire_lock)
+static size_t reclaim_locked(ObjectPool *pool)
 {
-    if (!pool || !callback)
+    try_advance_epoch(pool);
+
+    // Readers that saw an object retired in epoch e have all left once the epoch reaches e + 2;
+    // epochs only advance under retire_lock, so the limbo list is ordered and ready objects form a prefix
+    uint64_t epoch = atomic_load(&pool->epoch);
+    size_t ready = 0;
+    while (ready < pool->retired_count && pool->retired_epochs[ready] + 2 <= epoch)
+    {
+        ready++;
+    }
+    release_retired(pool, ready);
+    return ready;
+}
+
+// Defers releasing an object until every current reader has left its read section
+bool object_pool_retire(ObjectPool *pool, void *obj)
+{
+    if (!pool || !obj)
     {
-        log_error("object_pool_iterate_acquired received NULL pool or callback.");
+        LOG_ERROR("Invalid parameters for object_pool_retire.");
+        return false;
+    }
+
+    pthread_mutex_lock(&pool->retire_lock);
+    if (pool->retired_count == pool->retired_capacity)
+    {
+        size_t capacity = pool->retired_capacity ? pool->retired_capacity * 2 : OBJECT_POOL_RETIRE_BATCH;
+        void **retired = realloc(pool->retired, capacity * sizeof(void *));
+        if (retired)
+        {
+            pool->retired = retired;
+        }
+        uint64_t *epochs = retired ? realloc(pool->retired_epochs, capacity * sizeof(uint64_t)) : NULL;
+        if (!epochs)
+        {
+            pthread_mutex_unlock(&pool->retire_lock);
+            LOG_ERROR("Failed to grow the retired object list.");
+            return false;
+        }
+        pool->retired_epochs = epochs;
+        pool->retired_capacity = capacity;
+    }
+
+    pool->retired[pool->retired_count] = obj;
+    pool->retired_epochs[pool->retired_count] = atomic_load(&pool->epoch);
+    pool->retired_count++;
+
+    // Amortize the reader scan over a batch of retirements
+    if (pool->retired_count % OBJECT_POOL_RETIRE_BATCH == 0)
+    {
+        reclaim_locked(pool);
+    }
+    pthread_mutex_unlock(&pool->retire_lock);
+    return true;
+}
+
+// Releases every retired object whose grace period has passed
+size_t object_pool_reclaim(ObjectPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_reclaim received NULL pool pointer.");
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->retire_lock);
+    size_t released = reclaim_locked(pool);
+    pthread_mutex_unlock(&pool->retire_lock);
+    return released;
+}
+
+// Waits for a full grace period and releases every object retired before the call
+void object_pool_synchronize(ObjectPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("object_pool_synchronize received NULL pool pointer.");
         return;
     }
 
-    pthread_mutex_lock(&pool->lock);
-    AcquiredNode *current = pool->acquired_head;
-    while (current)
+    pthread_mutex_lock(&pool->retire_lock);
+    uint64_t target = atomic_load(&pool->epoch) + 2;
+    while (atomic_load(&pool->epoch) < target)
     {
-        callback(current->object, user_data);
-        current = current->next;
+        try_advance_epoch(pool);
+        if (atomic_load(&pool->epoch) < target)
+        {
+            pthread_mutex_unlock(&pool->retire_lock);
+            sched_yield();
+            pthread_mutex_lock(&pool->retire_lock);
+        }
     }
-    pthread_mutex_unlock(&pool->lock);
+    reclaim_locked(pool);
+    pthread_mutex_unlock(&pool->retire_lock);
 }
 
 // Resizes the object pool to add more objects
@@ -178,105 +2884,150 @@ bool object_pool_resize(ObjectPool *pool, size_t new_size)
 {
     if (!pool)
     {
-        log_error("object_pool_resize received NULL pool pointer.");
+        LOG_ERROR("object_pool_resize received NULL pool pointer.");
         return false;
     }
 
-    if (new_size <= pool->pool_size)
+    pool_lock(pool);
+
+    if (new_size <= current_size(pool))
     {
-        log_error("New size must be greater than the current pool size.");
+        pthread_mutex_unlock(&pool->lock);
+        LOG_ERROR("New size must be greater than the current pool size.");
         return false;
     }
 
-    pthread_mutex_lock(&pool->lock);
-
-    // Calculate the number of new objects to add
-    size_t additional_objects = new_size - pool->pool_size;
-
-    // Reallocate memory block
-    void *new_memory_block = realloc(pool->memory_block, new_size * pool->object_size);
-    if (!new_memory_block)
+    // Existing chunks stay where they are; only the new objects are allocated
+    size_t added = new_size - current_size(pool);
+    if (!add_chunk(pool, added))
     {
-        log_error("Failed to reallocate memory block for resizing.");
+        LOG_ERROR("Failed to allocate a new chunk for resizing.");
         pthread_mutex_unlock(&pool->lock);
         return false;
     }
-    pool->memory_block = new_memory_block;
 
-    // Reallocate free list
-    void **new_free_list = realloc(pool->free_list, new_size * sizeof(void *));
-    if (!new_free_list)
+    pool->resize_count++;
+    pthread_mutex_unlock(&pool->lock);
+    wake_waiters(pool, added);
+    LOG_INFO("Object pool resized to %zu objects.", new_size);
+    return true;
+}
+
+// Takes a snapshot of the pool's statistics
+bool object_pool_get_stats(ObjectPool *pool, ObjectPoolStats *stats)
+{
+    if (!pool || !stats)
     {
-        log_error("Failed to reallocate free list for resizing.");
-        pthread_mutex_unlock(&pool->lock);
+        LOG_ERROR("object_pool_get_stats received NULL pool or stats pointer.");
         return false;
     }
-    pool->free_list = new_free_list;
 
-    // Initialize new free objects
-    for (size_t i = pool->pool_size; i < new_size; i++)
+    memset(stats, 0, sizeof(*stats));
+    for (size_t i = 0; i < OBJECT_POOL_STAT_STRIPES; i++)
     {
-        pool->free_list[i] = (char *)pool->memory_block + i * pool->object_size;
+        ObjectPoolStatStripe *stripe = &pool->stats[i];
+        stats->acquires += atomic_load_explicit(&stripe->acquires, memory_order_relaxed);
+        stats->releases += atomic_load_explicit(&stripe->releases, memory_order_relaxed);
+        stats->failed_acquires += atomic_load_explicit(&stripe->failed_acquires, memory_order_relaxed);
+        stats->lock_contentions += atomic_load_explicit(&stripe->lock_contentions, memory_order_relaxed);
+        stats->lock_wait_ns += atomic_load_explicit(&stripe->lock_wait_ns, memory_order_relaxed);
+        for (size_t bucket = 0; bucket < OBJECT_POOL_LATENCY_BUCKETS; bucket++)
+        {
+            stats->acquire_latency[bucket] += atomic_load_explicit(&stripe->acquire_latency[bucket],
+                                                                   memory_order_relaxed);
+        }
     }
+    stats->in_use = stats->acquires > stats->releases ? (size_t)(stats->acquires - stats->releases) : 0;
+    stats->high_water_mark = atomic_load_explicit(&pool->high_water_mark, memory_order_relaxed);
+    stats->corruptions = atomic_load_explicit(&pool->corruptions, memory_order_relaxed);
 
-    pool->available += additional_objects;
-    pool->pool_size = new_size;
-
+    // Taken directly so that reading statistics does not show up as contention
+    pthread_mutex_lock(&pool->lock);
+    stats->pool_size = current_size(pool);
+    stats->available = atomic_load_explicit(&pool->available, memory_order_relaxed);
+    stats->resizes = pool->resize_count;
+    stats->shrinks = pool->shrink_count;
+    stats->relocations = pool->relocation_count;
     pthread_mutex_unlock(&pool->lock);
-    log_info("Object pool resized to %zu objects.", new_size);
     return true;
 }
 
+// Callback used by object_pool_destroy to report leaked objects
+static void log_leaked_object(void *object, void *user_data)
+{
+    (void)user_data;
+    LOG_WARNING("Leaked object at %p.", object);
+}
+
 // Destroys the object pool
 void object_pool_destroy(ObjectPool *pool)
 {
     if (!pool)
     {
-        log_error("object_pool_destroy received NULL pool pointer.");
+        LOG_ERROR("object_pool_destroy received NULL pool pointer.");
         return;
     }
 
-    pthread_mutex_lock(&pool->lock);
+    // No reader may be left at this point, so retired objects go straight back. This comes
+    // before the thread caches are torn down because the release may land in this thread's cache
+    pthread_mutex_lock(&pool->retire_lock);
+    release_retired(pool, pool->retired_count);
+    pthread_mutex_unlock(&pool->retire_lock);
 
-    // Check for memory leaks: if any objects are still acquired
-    if (pool->acquired_head != NULL)
+    // Return every thread's cached objects before tearing down the free list
+    pool_lock(pool);
+    ObjectPoolThreadCache *caches = pool->thread_caches;
+    pool->thread_caches = NULL;
+    pthread_mutex_unlock(&pool->lock);
+    while (caches)
     {
-        log_warning("Destroying pool with still-acquired objects.");
-        AcquiredNode *current = pool->acquired_head;
-        while (current)
-        {
-            log_warning("Leaked object at %p.", current->object);
-            current = current->next;
-        }
+        ObjectPoolThreadCache *cache = caches;
+        caches = cache->next;
+        shared_push(pool, cache->slots, cache->count);
+        free(cache);
+    }
+    if (pool->thread_cache_size > 0)
+    {
+        pthread_key_delete(pool->thread_cache_key);
+    }
+
+    free(pool->retired);
+    free(pool->retired_epochs);
+    if (atomic_load(&pool->epoch_key_ready))
+    {
+        pthread_key_delete(pool->epoch_key);
+    }
+    while (pool->epoch_records)
+    {
+        ObjectPoolEpochRecord *record = pool->epoch_records;
+        pool->epoch_records = record->next;
+        free(record);
     }
 
-    // Clean up the acquired list
-    AcquiredNode *current = pool->acquired_head;
-    while (current)
+    pool_lock(pool);
+
+    // Check for memory leaks: if any objects are still acquired
+    if (for_each_acquired(pool, NULL, NULL) > 0)
     {
-        AcquiredNode *temp = current;
-        current = current->next;
-        free(temp);
+        LOG_WARNING("Destroying pool with still-acquired objects.");
+        for_each_acquired(pool, log_leaked_object, NULL);
     }
-    pool->acquired_head = NULL;
 
-    free(pool->memory_block);
-    free(pool->free_list);
-    pool->memory_block = NULL;
-    pool->free_list = NULL;
-    pool->pool_size = 0;
-    pool->available = 0;
+    free_chunks(pool);
 
     pthread_mutex_unlock(&pool->lock);
 
+    pthread_mutex_destroy(&pool->retire_lock);
+    pthread_mutex_destroy(&pool->wait_lock);
     if (pthread_mutex_destroy(&pool->lock) != 0)
     {
-        log_warning("Failed to destroy mutex in object_pool_destroy.");
+        LOG_WARNING("Failed to destroy mutex in object_pool_destroy.");
     }
     else
     {
-        log_info("Mutex destroyed successfully.");
+        LOG_INFO("Mutex destroyed successfully.");
     }
 
-    log_info("Object pool destroyed.");
+    free(pool);
+    LOG_INFO("Object pool destroyed.");
 }
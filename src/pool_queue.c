@@ -0,0 +1,202 @@
+#include "pool_queue.h"
+#include <stdlib.h>
+#include <string.h>
+#include "cli_logger.h"
+
+// Ring cell; sequence == position when free for that position's producer, position + 1 once filled
+typedef struct PoolQueueCell
+{
+    OBJECT_POOL_ATOMIC(size_t) sequence; /**< Turn marker for the cell */
+    size_t index;                        /**< Slot index carried by the cell */
+} PoolQueueCell;
+
+// Creates a queue for objects of a pool
+bool pool_queue_init(PoolQueue **queue_ptr, ObjectPool *pool, size_t capacity)
+{
+    if (!queue_ptr || !pool || capacity == 0 || capacity > SIZE_MAX / 2 / sizeof(PoolQueueCell))
+    {
+        LOG_ERROR("Invalid parameters for pool_queue_init.");
+        return false;
+    }
+
+    // A power of two turns the position-to-cell mapping into a mask
+    size_t rounded = 2;
+    while (rounded < capacity)
+    {
+        rounded <<= 1;
+    }
+
+    PoolQueue *queue = aligned_alloc(POOL_QUEUE_CACHE_LINE, sizeof(PoolQueue));
+    if (!queue)
+    {
+        LOG_ERROR("Failed to allocate memory for PoolQueue.");
+        return false;
+    }
+    memset(queue, 0, sizeof(PoolQueue));
+
+    // aligned_alloc wants a multiple of the alignment, which only the smallest rings are not
+    size_t bytes = rounded * sizeof(PoolQueueCell);
+    bytes = (bytes + POOL_QUEUE_CACHE_LINE - 1) & ~(size_t)(POOL_QUEUE_CACHE_LINE - 1);
+    queue->cells = aligned_alloc(POOL_QUEUE_CACHE_LINE, bytes);
+    if (!queue->cells)
+    {
+        LOG_ERROR("Failed to allocate memory for queue cells.");
+        free(queue);
+        return false;
+    }
+
+    queue->pool = pool;
+    queue->capacity = rounded;
+    queue->mask = rounded - 1;
+    for (size_t i = 0; i < rounded; i++)
+    {
+        atomic_init(&queue->cells[i].sequence, i);
+    }
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+
+    LOG_INFO("Pool queue initialized with %zu entries.", rounded);
+    *queue_ptr = queue;
+    return true;
+}
+
+// Appends a slot index
+bool pool_queue_enqueue(PoolQueue *queue, size_t index)
+{
+    if (!queue || index == OBJECT_POOL_INVALID_INDEX)
+    {
+        LOG_ERROR("Invalid parameters for pool_queue_enqueue.");
+        return false;
+    }
+
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    PoolQueueCell *cell;
+    for (;;)
+    {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0)
+        {
+            // The cell is free for this position; claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer of the previous lap has not emptied the cell yet
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    cell->index = index;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+// Takes the oldest slot index
+bool pool_queue_dequeue(PoolQueue *queue, size_t *index)
+{
+    if (!queue || !index)
+    {
+        LOG_ERROR("Invalid parameters for pool_queue_dequeue.");
+        return false;
+    }
+
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    PoolQueueCell *cell;
+    for (;;)
+    {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        if (diff == 0)
+        {
+            // The cell holds this position's entry; claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The producer of this position has not filled the cell yet
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    *index = cell->index;
+    // Hand the cell to the producer one lap ahead
+    atomic_store_explicit(&cell->sequence, pos + queue->capacity, memory_order_release);
+    return true;
+}
+
+// Appends an acquired object by its slot index
+bool pool_queue_push(PoolQueue *queue, void *obj)
+{
+    if (!queue || !obj)
+    {
+        LOG_ERROR("Invalid parameters for pool_queue_push.");
+        return false;
+    }
+
+    size_t index = object_pool_index_of(queue->pool, obj);
+    if (index == OBJECT_POOL_INVALID_INDEX)
+    {
+        LOG_WARNING("Attempted to queue an object not belonging to the pool.");
+        return false;
+    }
+    return pool_queue_enqueue(queue, index);
+}
+
+// Takes the oldest object
+void *pool_queue_pop(PoolQueue *queue)
+{
+    size_t index;
+    return pool_queue_dequeue(queue, &index) ? object_pool_at(queue->pool, index) : NULL;
+}
+
+// Returns the number of queued entries
+size_t pool_queue_size(const PoolQueue *queue)
+{
+    if (!queue)
+    {
+        return 0;
+    }
+
+    size_t dequeue_pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    size_t enqueue_pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+}
+
+// Releases the queued objects and frees the queue
+void pool_queue_destroy(PoolQueue *queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+
+    // Queued objects are still acquired, and nobody else will ever dequeue them
+    void *obj;
+    while ((obj = pool_queue_pop(queue)) != NULL)
+    {
+        object_pool_release(queue->pool, obj);
+    }
+
+    free(queue->cells);
+    free(queue);
+    LOG_INFO("Pool queue destroyed.");
+}
@@ -0,0 +1,370 @@
+#define _GNU_SOURCE
+
+#include "sharded_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include "cli_logger.h"
+
+// Shards are padded to this size so neighboring shards never share a cache line
+#define SHARD_ALIGNMENT 64
+
+// Per-shard state; the shard's own free list lives in its ObjectPool
+typedef struct ShardedPoolShard
+{
+    _Alignas(SHARD_ALIGNMENT) pthread_mutex_t stash_lock; /**< Guards stash and stash_count */
+    ObjectPool *pool;                                     /**< Pool owning the shard's objects */
+    const char *base;                                     /**< First byte of the shard's object memory */
+    const char *end;                                      /**< One past the last byte of the shard's object memory */
+    void **stash;                                         /**< Objects stolen from other shards, not yet handed out */
+    size_t stash_count;                                   /**< Number of objects in stash */
+} ShardedPoolShard;
+
+// Round-robin shard assignment for threads on platforms without sched_getcpu
+static OBJECT_POOL_ATOMIC(size_t) next_thread_slot;
+static _Thread_local size_t thread_slot = SIZE_MAX;
+
+// Returns the shard serving the calling thread
+size_t sharded_pool_current_shard(const ShardedPool *pool)
+{
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0)
+    {
+        return (size_t)cpu % pool->shard_count;
+    }
+#endif
+    if (thread_slot == SIZE_MAX)
+    {
+        thread_slot = atomic_fetch_add_explicit(&next_thread_slot, 1, memory_order_relaxed);
+    }
+    return thread_slot % pool->shard_count;
+}
+
+// Helper function to destroy the first count shards and free the sharded pool
+static void destroy_shards(ShardedPool *pool, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        ShardedPoolShard *shard = &pool->shards[i];
+        if (shard->pool)
+        {
+            object_pool_destroy(shard->pool);
+        }
+        free(shard->stash);
+        pthread_mutex_destroy(&shard->stash_lock);
+    }
+    free(pool->by_address);
+    free(pool->shards);
+    free(pool);
+}
+
+// Helper function to set up one shard with its share of the objects
+static bool init_shard(ShardedPool *pool, ShardedPoolShard *shard, const ShardedPoolConfig *config, size_t size)
+{
+    if (pthread_mutex_init(&shard->stash_lock, NULL) != 0)
+    {
+        LOG_ERROR("Failed to initialize mutex.");
+        return false;
+    }
+
+    shard->stash = malloc(pool->steal_batch * sizeof(void *));
+    if (!shard->stash)
+    {
+        LOG_ERROR("Failed to allocate memory for shard stash.");
+        pthread_mutex_destroy(&shard->stash_lock);
+        return false;
+    }
+
+    ObjectPoolConfig pool_config = {0};
+    pool_config.initial_size = size;
+    pool_config.object_size = config->object_size;
+    pool_config.thread_cache_size = config->thread_cache_size;
+    pool_config.mode = config->mode;
+    pool_config.alignment = config->alignment;
+    if (!object_pool_init_ex(&shard->pool, &pool_config))
+    {
+        free(shard->stash);
+        pthread_mutex_destroy(&shard->stash_lock);
+        shard->pool = NULL;
+        shard->stash = NULL;
+        return false;
+    }
+
+    // Shards never grow, so all of a shard's objects live in its first chunk
+    const ObjectPoolChunk *chunk = &shard->pool->chunks[0];
+    shard->base = chunk->memory;
+    shard->end = chunk->memory + chunk->count * shard->pool->stride;
+    return true;
+}
+
+// Initializes the sharded pool
+bool sharded_pool_init(ShardedPool **pool_ptr, const ShardedPoolConfig *config)
+{
+    if (!pool_ptr || !config || config->total_size == 0 || config->object_size == 0)
+    {
+        LOG_ERROR("Invalid parameters for sharded_pool_init.");
+        return false;
+    }
+
+    size_t shard_count = config->shard_count;
+    if (shard_count == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        shard_count = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (shard_count > SHARDED_POOL_MAX_SHARDS)
+    {
+        shard_count = SHARDED_POOL_MAX_SHARDS;
+    }
+    if (shard_count > config->total_size)
+    {
+        shard_count = config->total_size;
+    }
+
+    ShardedPool *pool = calloc(1, sizeof(ShardedPool));
+    if (!pool)
+    {
+        LOG_ERROR("Failed to allocate memory for ShardedPool.");
+        return false;
+    }
+
+    size_t per_shard = config->total_size / shard_count;
+    pool->shard_count = shard_count;
+    pool->object_size = config->object_size;
+    pool->steal_batch = config->steal_batch ? config->steal_batch : (per_shard + 3) / 4;
+    atomic_init(&pool->steals, 0);
+    pool->shards = aligned_alloc(SHARD_ALIGNMENT, shard_count * sizeof(ShardedPoolShard));
+    pool->by_address = malloc(shard_count * sizeof(size_t));
+    if (!pool->shards || !pool->by_address)
+    {
+        LOG_ERROR("Failed to allocate memory for shards.");
+        destroy_shards(pool, 0);
+        return false;
+    }
+    memset(pool->shards, 0, shard_count * sizeof(ShardedPoolShard));
+
+    // Spread the remainder over the first shards so the total is exact
+    for (size_t i = 0; i < shard_count; i++)
+    {
+        size_t size = per_shard + (i < config->total_size % shard_count ? 1 : 0);
+        if (!init_shard(pool, &pool->shards[i], config, size))
+        {
+            destroy_shards(pool, i);
+            return false;
+        }
+    }
+
+    // Order shards by address so releases find their owner with a binary search
+    for (size_t i = 0; i < shard_count; i++)
+    {
+        size_t j = i;
+        while (j > 0 && pool->shards[pool->by_address[j - 1]].base > pool->shards[i].base)
+        {
+            pool->by_address[j] = pool->by_address[j - 1];
+            j--;
+        }
+        pool->by_address[j] = i;
+    }
+
+    LOG_INFO("Sharded pool initialized with %zu objects in %zu shards.", config->total_size, shard_count);
+    *pool_ptr = pool;
+    return true;
+}
+
+// Helper function to find the shard owning an object's memory
+static ShardedPoolShard *owner_shard(ShardedPool *pool, const void *obj)
+{
+    const char *p = obj;
+    size_t low = 0;
+    size_t high = pool->shard_count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (pool->shards[pool->by_address[mid]].base <= p)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if (low == 0)
+    {
+        return NULL;
+    }
+    ShardedPoolShard *shard = &pool->shards[pool->by_address[low - 1]];
+    return p < shard->end ? shard : NULL;
+}
+
+// Helper function to check whether a shard's shared free list has objects
+static inline bool shard_has_free(const ShardedPoolShard *shard)
+{
+    return atomic_load_explicit(&shard->pool->available, memory_order_relaxed) > 0;
+}
+
+// Helper function to take one object from a shard's stash
+static void *stash_pop(ShardedPoolShard *shard)
+{
+    void *obj = NULL;
+    pthread_mutex_lock(&shard->stash_lock);
+    if (shard->stash_count > 0)
+    {
+        obj = shard->stash[--shard->stash_count];
+    }
+    pthread_mutex_unlock(&shard->stash_lock);
+    return obj;
+}
+
+// Helper function to steal up to half of a victim's free objects into the home shard's stash
+static void *steal(ShardedPool *pool, ShardedPoolShard *home, ShardedPoolShard *victim)
+{
+    size_t available = atomic_load_explicit(&victim->pool->available, memory_order_relaxed);
+    if (available == 0)
+    {
+        return NULL;
+    }
+
+    size_t count = (available + 1) / 2;
+    if (count > pool->steal_batch)
+    {
+        count = pool->steal_batch;
+    }
+
+    // The stash is only refilled once empty, so it always has room for a full batch
+    void *obj = NULL;
+    pthread_mutex_lock(&home->stash_lock);
+    if (home->stash_count > 0)
+    {
+        // Another thread on this shard already stole a batch
+        obj = home->stash[--home->stash_count];
+    }
+    else
+    {
+        size_t stolen = object_pool_acquire_n(victim->pool, home->stash, count);
+        if (stolen > 0)
+        {
+            obj = home->stash[stolen - 1];
+            home->stash_count = stolen - 1;
+            atomic_fetch_add_explicit(&pool->steals, 1, memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&home->stash_lock);
+    return obj;
+}
+
+// Acquires an object from the calling CPU's shard, stealing from neighbors if it is empty
+void *sharded_pool_acquire(ShardedPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("sharded_pool_acquire received NULL pool pointer.");
+        return NULL;
+    }
+
+    size_t home_index = sharded_pool_current_shard(pool);
+    ShardedPoolShard *home = &pool->shards[home_index];
+
+    // Skip the home pool only when its shared list is empty and there is no thread cache to check
+    void *obj = NULL;
+    if (home->pool->thread_cache_size > 0 || shard_has_free(home))
+    {
+        obj = object_pool_acquire(home->pool);
+    }
+    if (!obj)
+    {
+        obj = stash_pop(home);
+    }
+
+    // Visit neighbors nearest first, so shards on adjacent CPUs absorb each other's bursts
+    for (size_t i = 1; !obj && i < pool->shard_count; i++)
+    {
+        obj = steal(pool, home, &pool->shards[(home_index + i) % pool->shard_count]);
+    }
+
+    // Objects can still sit in other shards' stashes after their pools run dry
+    for (size_t i = 1; !obj && i < pool->shard_count; i++)
+    {
+        obj = stash_pop(&pool->shards[(home_index + i) % pool->shard_count]);
+    }
+
+    if (!obj)
+    {
+        LOG_WARNING("Sharded pool is empty. Cannot acquire object.");
+    }
+    return obj;
+}
+
+// Releases an object to the shard that owns it
+void sharded_pool_release(ShardedPool *pool, void *obj)
+{
+    if (!pool || !obj)
+    {
+        LOG_ERROR("Invalid parameters for sharded_pool_release.");
+        return;
+    }
+
+    ShardedPoolShard *owner = owner_shard(pool, obj);
+    if (!owner)
+    {
+        LOG_WARNING("Attempted to release an object not acquired from the sharded pool.");
+        return;
+    }
+    object_pool_release(owner->pool, obj);
+}
+
+// Counts the free objects across all shards
+size_t sharded_pool_available(ShardedPool *pool)
+{
+    if (!pool)
+    {
+        return 0;
+    }
+
+    size_t available = 0;
+    for (size_t i = 0; i < pool->shard_count; i++)
+    {
+        ShardedPoolShard *shard = &pool->shards[i];
+        available += atomic_load_explicit(&shard->pool->available, memory_order_relaxed);
+        pthread_mutex_lock(&shard->stash_lock);
+        available += shard->stash_count;
+        pthread_mutex_unlock(&shard->stash_lock);
+    }
+    return available;
+}
+
+// Returns the object pool backing a shard
+ObjectPool *sharded_pool_shard(ShardedPool *pool, size_t index)
+{
+    if (!pool || index >= pool->shard_count)
+    {
+        return NULL;
+    }
+    return pool->shards[index].pool;
+}
+
+// Destroys every shard and frees the sharded pool
+void sharded_pool_destroy(ShardedPool *pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    // Stashed objects are still acquired from their owners; return them first
+    for (size_t i = 0; i < pool->shard_count; i++)
+    {
+        ShardedPoolShard *shard = &pool->shards[i];
+        for (size_t j = 0; j < shard->stash_count; j++)
+        {
+            object_pool_release(owner_shard(pool, shard->stash[j])->pool, shard->stash[j]);
+        }
+        shard->stash_count = 0;
+    }
+
+    destroy_shards(pool, pool->shard_count);
+    LOG_INFO("Sharded pool destroyed.");
+}
@@ -0,0 +1,492 @@
+#define _GNU_SOURCE
+
+#include "shm_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include "cli_logger.h"
+#include "lf_stack.h"
+
+// Written last by the creator, so an attaching process never sees a half-built segment
+#define SHM_POOL_MAGIC 0x0B5E55A1u
+#define SHM_POOL_VERSION 2u
+
+// Objects are aligned like malloc memory, the slab to a cache line
+#define OBJECT_ALIGNMENT 16
+#define SLAB_ALIGNMENT 64
+
+// Helper to round a segment offset up to a power-of-two alignment
+#define ALIGN_UP(value, alignment) (((value) + (alignment) - 1) & ~((uint64_t)(alignment) - 1))
+
+// Segment header; everything after it is located by offset so each process may map it anywhere
+typedef struct ShmPoolHeader
+{
+    OBJECT_POOL_ATOMIC(uint32_t) magic;     /**< SHM_POOL_MAGIC once the segment is initialized */
+    uint32_t version;                       /**< Layout version */
+    uint64_t segment_size;                  /**< Total size of the segment */
+    uint64_t capacity;                      /**< Number of objects */
+    uint64_t object_size;                   /**< Size of each object */
+    uint64_t stride;                        /**< Distance between consecutive objects */
+    uint64_t free_next_offset;              /**< Offset of the per-slot free list links */
+    uint64_t bitmap_offset;                 /**< Offset of the acquired bitmap */
+    uint64_t slab_offset;                   /**< Offset of the first object */
+    OBJECT_POOL_ATOMIC(uint64_t) free_head; /**< Tagged stack head: ABA tag << 32 | slot index */
+    OBJECT_POOL_ATOMIC(uint64_t) available; /**< Number of free objects */
+    uint64_t base_hint;                     /**< Address the segment was last mapped at (file-backed pools) */
+    OBJECT_POOL_ATOMIC(uint32_t) dirty;     /**< Set while a file-backed pool is open; still set after a crash */
+} ShmPoolHeader;
+
+// Helper function to lay out a segment for capacity objects of object_size bytes
+static void segment_layout(ShmPoolHeader *layout, size_t capacity, size_t object_size)
+{
+    layout->capacity = capacity;
+    layout->object_size = object_size;
+    layout->stride = ALIGN_UP(object_size, OBJECT_ALIGNMENT);
+    layout->free_next_offset = ALIGN_UP(sizeof(ShmPoolHeader), sizeof(uint64_t));
+    layout->bitmap_offset = ALIGN_UP(layout->free_next_offset + capacity * sizeof(uint32_t), sizeof(uint64_t));
+    layout->slab_offset = ALIGN_UP(layout->bitmap_offset + BITMAP_WORDS(capacity) * sizeof(uint64_t), SLAB_ALIGNMENT);
+    layout->segment_size = layout->slab_offset + capacity * layout->stride;
+}
+
+// Helper function to map a segment and fill in a process-local attachment
+static bool attach(ShmPool **pool_ptr, int fd, void *hint)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmPoolHeader))
+    {
+        LOG_ERROR("Shared memory segment is missing or too small.");
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    ShmPoolHeader *header = mmap(hint, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED)
+    {
+        LOG_ERROR("Failed to map shared memory segment.");
+        close(fd);
+        return false;
+    }
+
+    // Check the layout against the segment before trusting any offset in it
+    ShmPoolHeader expected = {0};
+    bool valid = atomic_load_explicit(&header->magic, memory_order_acquire) == SHM_POOL_MAGIC &&
+                 header->version == SHM_POOL_VERSION && header->segment_size == size &&
+                 header->capacity > 0 && header->capacity < LF_NIL && header->object_size > 0;
+    if (valid)
+    {
+        segment_layout(&expected, header->capacity, header->object_size);
+        valid = expected.segment_size == size && expected.slab_offset == header->slab_offset &&
+                expected.free_next_offset == header->free_next_offset &&
+                expected.bitmap_offset == header->bitmap_offset && expected.stride == header->stride;
+    }
+    if (!valid)
+    {
+        LOG_ERROR("Shared memory segment does not hold an initialized object pool.");
+        munmap(header, size);
+        close(fd);
+        return false;
+    }
+
+    ShmPool *pool = calloc(1, sizeof(ShmPool));
+    if (!pool)
+    {
+        LOG_ERROR("Failed to allocate memory for ShmPool.");
+        munmap(header, size);
+        close(fd);
+        return false;
+    }
+
+    char *base = (char *)header;
+    pool->header = header;
+    pool->mapped_size = size;
+    pool->fd = fd;
+    pool->free_next = (OBJECT_POOL_ATOMIC(uint32_t) *)(base + header->free_next_offset);
+    pool->acquired_bitmap = (OBJECT_POOL_ATOMIC(uint64_t) *)(base + header->bitmap_offset);
+    pool->slab = base + header->slab_offset;
+    pool->capacity = header->capacity;
+    pool->object_size = header->object_size;
+    pool->stride = header->stride;
+    *pool_ptr = pool;
+    return true;
+}
+
+// Helper function to size a new segment and build an empty pool in it
+static bool init_segment(int fd, size_t capacity, size_t object_size)
+{
+    ShmPoolHeader layout;
+    segment_layout(&layout, capacity, object_size);
+    ShmPoolHeader *header = MAP_FAILED;
+    if (ftruncate(fd, (off_t)layout.segment_size) == 0)
+    {
+        header = mmap(NULL, layout.segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (header == MAP_FAILED)
+    {
+        LOG_ERROR("Failed to size and map shared memory segment.");
+        return false;
+    }
+
+    // The segment starts zeroed, which is an empty acquired bitmap
+    header->version = SHM_POOL_VERSION;
+    header->segment_size = layout.segment_size;
+    header->capacity = layout.capacity;
+    header->object_size = layout.object_size;
+    header->stride = layout.stride;
+    header->free_next_offset = layout.free_next_offset;
+    header->bitmap_offset = layout.bitmap_offset;
+    header->slab_offset = layout.slab_offset;
+
+    OBJECT_POOL_ATOMIC(uint32_t) *free_next = (OBJECT_POOL_ATOMIC(uint32_t) *)((char *)header + layout.free_next_offset);
+    for (size_t i = 0; i < capacity; i++)
+    {
+        atomic_init(&free_next[i], i + 1 < capacity ? (uint32_t)(i + 1) : LF_NIL);
+    }
+    atomic_init(&header->free_head, LF_HEAD(0, 0));
+    atomic_init(&header->available, capacity);
+    atomic_init(&header->dirty, 0);
+    atomic_store_explicit(&header->magic, SHM_POOL_MAGIC, memory_order_release);
+    munmap(header, layout.segment_size);
+    return true;
+}
+
+// Creates a pool in a new named segment or memfd
+bool shm_pool_create(ShmPool **pool_ptr, const char *name, size_t capacity, size_t object_size)
+{
+    if (!pool_ptr || capacity == 0 || capacity >= LF_NIL || object_size == 0)
+    {
+        LOG_ERROR("Invalid parameters for shm_pool_create.");
+        return false;
+    }
+
+    int fd = name ? shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600) : memfd_create("object_pool", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        LOG_ERROR("Failed to create shared memory segment %s.", name ? name : "(memfd)");
+        return false;
+    }
+
+    // attach closes fd when it fails; init_segment leaves that to the caller
+    bool initialized = init_segment(fd, capacity, object_size);
+    if (!initialized)
+    {
+        close(fd);
+    }
+    if (!initialized || !attach(pool_ptr, fd, NULL))
+    {
+        if (name)
+        {
+            shm_unlink(name);
+        }
+        return false;
+    }
+
+    LOG_INFO("Shared memory pool %s created with %zu objects.", name ? name : "(memfd)", capacity);
+    return true;
+}
+
+// Helper function to rebuild the free stack from the acquired bitmap after an unclean shutdown
+static void recover_free_list(ShmPool *pool)
+{
+    // A crash between a stack update and the matching bitmap update leaves the two out of step;
+    // the bitmap is the record of which objects the application still holds
+    uint32_t head = LF_NIL;
+    size_t available = 0;
+    for (size_t i = pool->capacity; i-- > 0;)
+    {
+        uint64_t word = atomic_load_explicit(&pool->acquired_bitmap[BITMAP_WORD(i)], memory_order_relaxed);
+        if (!(word & BITMAP_BIT(i)))
+        {
+            atomic_store_explicit(&pool->free_next[i], head, memory_order_relaxed);
+            head = (uint32_t)i;
+            available++;
+        }
+    }
+
+    uint64_t old = atomic_load_explicit(&pool->header->free_head, memory_order_relaxed);
+    atomic_store_explicit(&pool->header->free_head, LF_HEAD(head, LF_HEAD_TAG(old) + 1), memory_order_relaxed);
+    atomic_store_explicit(&pool->header->available, available, memory_order_relaxed);
+    LOG_WARNING("Persistent pool was not closed cleanly; rebuilt the free list with %zu free objects.", available);
+}
+
+// Opens a file-backed pool, creating the file if it does not exist
+bool shm_pool_open_file(ShmPool **pool_ptr, const char *path, size_t capacity, size_t object_size)
+{
+    if (!pool_ptr || !path || capacity == 0 || capacity >= LF_NIL || object_size == 0)
+    {
+        LOG_ERROR("Invalid parameters for shm_pool_open_file.");
+        return false;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        LOG_ERROR("Failed to open pool file %s.", path);
+        return false;
+    }
+
+    // One process owns a persistent pool at a time; the lock goes away with the process
+    struct stat st;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0 || fstat(fd, &st) != 0)
+    {
+        LOG_ERROR("Pool file %s is in use by another process.", path);
+        close(fd);
+        return false;
+    }
+
+    bool created = st.st_size == 0;
+    if (created && !init_segment(fd, capacity, object_size))
+    {
+        // Leave the file empty so the next open initializes it again instead of rejecting it
+        if (ftruncate(fd, 0) != 0)
+        {
+            LOG_WARNING("Failed to truncate pool file %s.", path);
+        }
+        close(fd);
+        return false;
+    }
+
+    // Map at the previous address when possible, so pointers stored inside objects stay valid
+    uint64_t hint = 0;
+    if (!created && pread(fd, &hint, sizeof(hint), (off_t)offsetof(ShmPoolHeader, base_hint)) != sizeof(hint))
+    {
+        hint = 0;
+    }
+
+    ShmPool *pool;
+    if (!attach(&pool, fd, (void *)(uintptr_t)hint))
+    {
+        return false;
+    }
+
+    if (pool->capacity != capacity || pool->object_size != object_size)
+    {
+        LOG_ERROR("Pool file %s holds %zu objects of %zu bytes, not %zu of %zu.", path, pool->capacity,
+                  pool->object_size, capacity, object_size);
+        shm_pool_close(pool);
+        return false;
+    }
+
+    pool->persistent = true;
+    if (atomic_load_explicit(&pool->header->dirty, memory_order_relaxed))
+    {
+        recover_free_list(pool);
+    }
+    pool->header->base_hint = (uint64_t)(uintptr_t)pool->header;
+    atomic_store_explicit(&pool->header->dirty, 1, memory_order_relaxed);
+
+    LOG_INFO("Persistent pool %s %s with %zu of %zu objects in use.", path, created ? "created" : "reopened",
+             pool->capacity - shm_pool_available(pool), pool->capacity);
+    *pool_ptr = pool;
+    return true;
+}
+
+// Attaches to a named segment
+bool shm_pool_open(ShmPool **pool_ptr, const char *name)
+{
+    if (!pool_ptr || !name)
+    {
+        LOG_ERROR("Invalid parameters for shm_pool_open.");
+        return false;
+    }
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        LOG_ERROR("Failed to open shared memory segment %s.", name);
+        return false;
+    }
+    return attach(pool_ptr, fd, NULL);
+}
+
+// Attaches to a segment through a descriptor
+bool shm_pool_open_fd(ShmPool **pool_ptr, int fd)
+{
+    if (!pool_ptr || fd < 0)
+    {
+        LOG_ERROR("Invalid parameters for shm_pool_open_fd.");
+        return false;
+    }
+
+    int own_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own_fd < 0)
+    {
+        LOG_ERROR("Failed to duplicate shared memory descriptor.");
+        return false;
+    }
+    return attach(pool_ptr, own_fd, NULL);
+}
+
+// Helper function to map an object pointer to its slot index, or return false if it is not a slot
+static bool slot_index(const ShmPool *pool, const void *obj, size_t *index)
+{
+    const char *p = obj;
+    if (p < pool->slab || p >= pool->slab + pool->capacity * pool->stride)
+    {
+        return false;
+    }
+
+    size_t offset = (size_t)(p - pool->slab);
+    if (offset % pool->stride != 0)
+    {
+        return false;
+    }
+    *index = offset / pool->stride;
+    return true;
+}
+
+// Acquires an object from the shared free stack
+void *shm_pool_acquire(ShmPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("shm_pool_acquire received NULL pool pointer.");
+        return NULL;
+    }
+
+    uint32_t index = lf_stack_pop(&pool->header->free_head, lf_array_link, pool->free_next);
+    if (index == LF_NIL)
+    {
+        LOG_WARNING("Shared memory pool is empty. Cannot acquire object.");
+        return NULL;
+    }
+
+    atomic_fetch_sub_explicit(&pool->header->available, 1, memory_order_relaxed);
+    atomic_fetch_or_explicit(&pool->acquired_bitmap[BITMAP_WORD(index)], BITMAP_BIT(index), memory_order_relaxed);
+    return pool->slab + (size_t)index * pool->stride;
+}
+
+// Releases an object to the shared free stack
+void shm_pool_release(ShmPool *pool, void *obj)
+{
+    if (!pool || !obj)
+    {
+        LOG_ERROR("Invalid parameters for shm_pool_release.");
+        return;
+    }
+
+    size_t index;
+    uint64_t bit = 0;
+    if (slot_index(pool, obj, &index))
+    {
+        bit = BITMAP_BIT(index);
+        bit &= atomic_fetch_and_explicit(&pool->acquired_bitmap[BITMAP_WORD(index)], ~bit, memory_order_relaxed);
+    }
+    if (!bit)
+    {
+        LOG_WARNING("Attempted to release an object not acquired from the shared memory pool.");
+        return;
+    }
+
+    lf_stack_push_chain(&pool->header->free_head, (uint32_t)index, &pool->free_next[index]);
+    atomic_fetch_add_explicit(&pool->header->available, 1, memory_order_relaxed);
+}
+
+// Converts an object pointer to a segment offset
+uint64_t shm_pool_offset(const ShmPool *pool, const void *obj)
+{
+    size_t index;
+    if (!pool || !obj || !slot_index(pool, obj, &index))
+    {
+        return SHM_POOL_NULL_OFFSET;
+    }
+    return pool->header->slab_offset + index * pool->stride;
+}
+
+// Converts a segment offset to an object pointer in this process's mapping
+void *shm_pool_pointer(const ShmPool *pool, uint64_t offset)
+{
+    if (!pool || offset < pool->header->slab_offset || offset >= pool->mapped_size)
+    {
+        return NULL;
+    }
+
+    uint64_t relative = offset - pool->header->slab_offset;
+    if (relative % pool->stride != 0)
+    {
+        return NULL;
+    }
+    return pool->slab + relative;
+}
+
+// Returns the number of free objects
+size_t shm_pool_available(const ShmPool *pool)
+{
+    return pool ? (size_t)atomic_load_explicit(&pool->header->available, memory_order_relaxed) : 0;
+}
+
+// Returns the descriptor of the segment
+int shm_pool_fd(const ShmPool *pool)
+{
+    return pool ? pool->fd : -1;
+}
+
+// Visits every acquired object
+size_t shm_pool_iterate_acquired(ShmPool *pool, object_callback callback, void *user_data)
+{
+    if (!pool || !callback)
+    {
+        LOG_ERROR("shm_pool_iterate_acquired received NULL pool or callback.");
+        return 0;
+    }
+
+    size_t found = 0;
+    for (size_t word = 0; word < BITMAP_WORDS(pool->capacity); word++)
+    {
+        uint64_t bits = atomic_load_explicit(&pool->acquired_bitmap[word], memory_order_relaxed);
+        while (bits)
+        {
+            size_t index = word * 64 + (size_t)__builtin_ctzll(bits);
+            callback(pool->slab + index * pool->stride, user_data);
+            bits &= bits - 1;
+            found++;
+        }
+    }
+    return found;
+}
+
+// Writes the segment back to its file
+bool shm_pool_sync(ShmPool *pool)
+{
+    if (!pool || msync(pool->header, pool->mapped_size, MS_SYNC) != 0)
+    {
+        LOG_ERROR("Failed to sync pool to its backing file.");
+        return false;
+    }
+    return true;
+}
+
+// Unmaps the segment and frees the attachment
+void shm_pool_close(ShmPool *pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    // Flush the objects before marking the file clean, so a crash in between still triggers recovery
+    if (pool->persistent && shm_pool_sync(pool))
+    {
+        atomic_store_explicit(&pool->header->dirty, 0, memory_order_relaxed);
+        msync(pool->header, sizeof(ShmPoolHeader), MS_SYNC);
+    }
+
+    munmap(pool->header, pool->mapped_size);
+    close(pool->fd);
+    free(pool);
+}
+
+// Removes a named segment
+bool shm_pool_unlink(const char *name)
+{
+    if (!name || shm_unlink(name) != 0)
+    {
+        LOG_ERROR("Failed to unlink shared memory segment %s.", name ? name : "(null)");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,369 @@
+#include "size_class_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include "cli_logger.h"
+
+// Classes below this size are spaced 16 bytes apart
+#define SMALL_CLASS_LIMIT 128
+#define SMALL_CLASS_COUNT (SMALL_CLASS_LIMIT / 16)
+
+// Pooled blocks are aligned like malloc memory
+#define CLASS_ALIGNMENT 16
+
+// Page map geometry: a page number splits into a root index and a leaf index
+#define MAP_PAGE_SIZE ((size_t)1 << SIZE_CLASS_POOL_PAGE_SHIFT)
+#define LEAF_ENTRIES ((size_t)1 << SIZE_CLASS_POOL_LEAF_BITS)
+#define ROOT_ENTRIES ((size_t)1 << SIZE_CLASS_POOL_ROOT_BITS)
+
+// Page map entries: 0 for unknown pages, (class + 1) << 1 for class pages, size << 1 | 1 for large allocations
+#define PAGE_CLASS(index) ((uint64_t)((index) + 1) << 1)
+#define PAGE_LARGE(size) ((uint64_t)(size) << 1 | 1)
+#define PAGE_IS_LARGE(entry) (((entry) & 1) != 0)
+
+// Maps a request size to its size class index
+size_t size_class_index(size_t size)
+{
+    if (size <= SMALL_CLASS_LIMIT)
+    {
+        return size == 0 ? 0 : (size - 1) / 16;
+    }
+
+    // Four classes per doubling: lg picks the doubling, the top two bits below it the class
+    size_t lg = 63 - (size_t)__builtin_clzll((unsigned long long)(size - 1));
+    return SMALL_CLASS_COUNT + (lg - 7) * 4 + (((size - 1) >> (lg - 2)) - 4);
+}
+
+// Returns the object size served by a size class
+size_t size_class_size(size_t index)
+{
+    if (index < SMALL_CLASS_COUNT)
+    {
+        return (index + 1) * 16;
+    }
+
+    size_t group = (index - SMALL_CLASS_COUNT) / 4;
+    size_t step = (index - SMALL_CLASS_COUNT) % 4;
+    return (SMALL_CLASS_LIMIT + (step + 1) * 32) << group;
+}
+
+// Initializes the size-class allocator
+bool size_class_pool_init(SizeClassPool **pool_ptr, const SizeClassPoolConfig *config)
+{
+    SizeClassPoolConfig defaults = {0};
+    if (!config)
+    {
+        config = &defaults;
+    }
+
+    if (!pool_ptr || config->max_class_size > SIZE_CLASS_POOL_MAX_CLASS_SIZE)
+    {
+        LOG_ERROR("Invalid parameters for size_class_pool_init.");
+        return false;
+    }
+
+    SizeClassPool *pool = calloc(1, sizeof(SizeClassPool));
+    if (!pool)
+    {
+        LOG_ERROR("Failed to allocate memory for SizeClassPool.");
+        return false;
+    }
+
+    pool->max_class_size = config->max_class_size ? config->max_class_size : 4096;
+    pool->class_count = size_class_index(pool->max_class_size) + 1;
+    pool->max_class_size = size_class_size(pool->class_count - 1);
+    pool->objects_per_class = config->objects_per_class ? config->objects_per_class : 64;
+    pool->thread_cache_size = config->thread_cache_size;
+    pool->mode = config->mode;
+    for (size_t i = 0; i < SIZE_CLASS_POOL_MAX_CLASSES; i++)
+    {
+        atomic_init(&pool->classes[i], NULL);
+        atomic_init(&pool->mapped_chunks[i], 0);
+    }
+
+    // The root is only touched where leaves exist, so most of it stays unbacked zero pages
+    pool->page_map = calloc(ROOT_ENTRIES, sizeof(*pool->page_map));
+    if (!pool->page_map)
+    {
+        LOG_ERROR("Failed to allocate memory for the page map.");
+        free(pool);
+        return false;
+    }
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0)
+    {
+        LOG_ERROR("Failed to initialize mutex.");
+        free(pool->page_map);
+        free(pool);
+        return false;
+    }
+
+    LOG_INFO("Size class pool initialized with %zu classes up to %zu bytes.", pool->class_count,
+             pool->max_class_size);
+    *pool_ptr = pool;
+    return true;
+}
+
+// Helper function to get the page map entry of a page, or NULL if no leaf covers it (create allocates the leaf)
+static OBJECT_POOL_ATOMIC(uint64_t) *page_entry(SizeClassPool *pool, uintptr_t page, bool create)
+{
+    uintptr_t root = page >> SIZE_CLASS_POOL_LEAF_BITS;
+    if (root >= ROOT_ENTRIES)
+    {
+        return NULL;
+    }
+
+    SizeClassPageLeaf leaf = atomic_load_explicit(&pool->page_map[root], memory_order_acquire);
+    if (!leaf && create)
+    {
+        // Leaves are only created under the lock, so no other thread can publish this one meanwhile
+        leaf = calloc(LEAF_ENTRIES, sizeof(*leaf));
+        if (!leaf)
+        {
+            LOG_ERROR("Failed to allocate memory for a page map leaf.");
+            return NULL;
+        }
+        atomic_store_explicit(&pool->page_map[root], leaf, memory_order_release);
+    }
+    return leaf ? &leaf[page & (LEAF_ENTRIES - 1)] : NULL;
+}
+
+// Helper function to record bytes starting at a page boundary under one entry (caller holds the lock)
+static bool map_pages(SizeClassPool *pool, const void *memory, size_t bytes, uint64_t entry)
+{
+    uintptr_t first = (uintptr_t)memory >> SIZE_CLASS_POOL_PAGE_SHIFT;
+    uintptr_t last = ((uintptr_t)memory + bytes - 1) >> SIZE_CLASS_POOL_PAGE_SHIFT;
+    for (uintptr_t page = first; page <= last; page++)
+    {
+        OBJECT_POOL_ATOMIC(uint64_t) *slot = page_entry(pool, page, true);
+        if (!slot)
+        {
+            return false;
+        }
+        atomic_store_explicit(slot, entry, memory_order_release);
+    }
+    return true;
+}
+
+// Helper function to look up the page map entry of ptr; 0 means the pointer is not ours
+static uint64_t page_lookup(SizeClassPool *pool, const void *ptr)
+{
+    OBJECT_POOL_ATOMIC(uint64_t) *slot = page_entry(pool, (uintptr_t)ptr >> SIZE_CLASS_POOL_PAGE_SHIFT, false);
+    return slot ? atomic_load_explicit(slot, memory_order_acquire) : 0;
+}
+
+// Helper function to record the chunks a class pool added since the last call; false if the map is full
+static bool map_class_chunks(SizeClassPool *pool, size_t index, ObjectPool *class)
+{
+    // Class pools never shrink, so the chunk count only grows and each chunk is recorded once
+    size_t chunk_count = atomic_load_explicit(&class->chunk_count, memory_order_acquire);
+    if (atomic_load_explicit(&pool->mapped_chunks[index], memory_order_acquire) == chunk_count)
+    {
+        return true;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    size_t mapped = atomic_load_explicit(&pool->mapped_chunks[index], memory_order_relaxed);
+    while (mapped < chunk_count &&
+           map_pages(pool, class->chunks[mapped].memory, class->chunks[mapped].mapped_size, PAGE_CLASS(index)))
+    {
+        mapped++;
+    }
+    atomic_store_explicit(&pool->mapped_chunks[index], mapped, memory_order_release);
+    pthread_mutex_unlock(&pool->lock);
+    return mapped >= chunk_count;
+}
+
+// Helper function to get a class pool, creating it on first use
+static ObjectPool *class_pool(SizeClassPool *pool, size_t index)
+{
+    ObjectPool *class = atomic_load_explicit(&pool->classes[index], memory_order_acquire);
+    if (class)
+    {
+        return class;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    class = atomic_load_explicit(&pool->classes[index], memory_order_relaxed);
+    if (!class)
+    {
+        ObjectPoolConfig config = {0};
+        config.initial_size = pool->objects_per_class;
+        config.object_size = size_class_size(index);
+        config.alignment = CLASS_ALIGNMENT;
+        config.thread_cache_size = pool->thread_cache_size;
+        config.mode = pool->mode;
+        config.growth = OBJECT_POOL_GROWTH_GEOMETRIC;
+        config.own_pages = true;
+        if (object_pool_init_ex(&class, &config))
+        {
+            atomic_store_explicit(&pool->classes[index], class, memory_order_release);
+        }
+        else
+        {
+            class = NULL;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return class;
+}
+
+// Allocates memory from the size class matching the request
+void *size_class_pool_alloc(SizeClassPool *pool, size_t size)
+{
+    if (!pool)
+    {
+        LOG_ERROR("size_class_pool_alloc received NULL pool pointer.");
+        return NULL;
+    }
+
+    if (size <= pool->max_class_size)
+    {
+        size_t index = size_class_index(size);
+        ObjectPool *class = class_pool(pool, index);
+        void *block = class ? object_pool_acquire(class) : NULL;
+        if (block && !map_class_chunks(pool, index, class))
+        {
+            object_pool_release(class, block);
+            return NULL;
+        }
+        return block;
+    }
+
+    // Large blocks own their pages, so the map entry of the first one can hold the size
+    if (size > (SIZE_MAX >> 1) - MAP_PAGE_SIZE)
+    {
+        return NULL;
+    }
+    size_t bytes = (size + MAP_PAGE_SIZE - 1) & ~(MAP_PAGE_SIZE - 1);
+    void *block = aligned_alloc(MAP_PAGE_SIZE, bytes);
+    if (!block)
+    {
+        LOG_ERROR("Failed to allocate %zu bytes.", size);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    bool mapped = map_pages(pool, block, MAP_PAGE_SIZE, PAGE_LARGE(size));
+    pthread_mutex_unlock(&pool->lock);
+    if (!mapped)
+    {
+        free(block);
+        return NULL;
+    }
+    return block;
+}
+
+// Helper function to find the class that owns ptr; returns class_count if no class does
+static size_t class_of(SizeClassPool *pool, const void *ptr, ObjectPool **class_out)
+{
+    uint64_t entry = page_lookup(pool, ptr);
+    if (entry == 0 || PAGE_IS_LARGE(entry))
+    {
+        return pool->class_count;
+    }
+
+    size_t index = (size_t)(entry >> 1) - 1;
+    *class_out = atomic_load_explicit(&pool->classes[index], memory_order_acquire);
+    return index;
+}
+
+// Helper function to get the slot of a live large allocation, or NULL if ptr is not one
+static OBJECT_POOL_ATOMIC(uint64_t) *large_entry_of(SizeClassPool *pool, const void *ptr)
+{
+    // Only the first page of a large allocation is marked, and only its start is a valid pointer
+    OBJECT_POOL_ATOMIC(uint64_t) *slot = NULL;
+    if (((uintptr_t)ptr & (MAP_PAGE_SIZE - 1)) == 0)
+    {
+        slot = page_entry(pool, (uintptr_t)ptr >> SIZE_CLASS_POOL_PAGE_SHIFT, false);
+    }
+    if (!slot || !PAGE_IS_LARGE(atomic_load_explicit(slot, memory_order_acquire)))
+    {
+        LOG_WARNING("Pointer %p was not allocated by this size class pool.", ptr);
+        return NULL;
+    }
+    return slot;
+}
+
+// Returns memory to the size class it came from
+void size_class_pool_free(SizeClassPool *pool, void *ptr)
+{
+    if (!pool)
+    {
+        LOG_ERROR("size_class_pool_free received NULL pool pointer.");
+        return;
+    }
+    if (!ptr)
+    {
+        return;
+    }
+
+    // Releasing a block that is not acquired is rejected by its class pool
+    ObjectPool *class;
+    if (class_of(pool, ptr, &class) < pool->class_count)
+    {
+        object_pool_release(class, ptr);
+        return;
+    }
+
+    // Clearing the entry first makes a racing or repeated free of the same block fail the lookup
+    OBJECT_POOL_ATOMIC(uint64_t) *slot = large_entry_of(pool, ptr);
+    uint64_t entry = slot ? atomic_load_explicit(slot, memory_order_acquire) : 0;
+    if (slot && PAGE_IS_LARGE(entry) && atomic_compare_exchange_strong(slot, &entry, 0))
+    {
+        free(ptr);
+    }
+}
+
+// Returns the usable size of an allocation
+size_t size_class_pool_usable_size(SizeClassPool *pool, const void *ptr)
+{
+    if (!pool || !ptr)
+    {
+        return 0;
+    }
+
+    ObjectPool *class;
+    size_t index = class_of(pool, ptr, &class);
+    if (index < pool->class_count)
+    {
+        // A freed block is the first free slot at or after its own
+        size_t slot = object_pool_index_of(class, ptr);
+        if (slot == OBJECT_POOL_INVALID_INDEX || object_pool_find_free(class, slot) == slot)
+        {
+            return 0;
+        }
+        return size_class_size(index);
+    }
+
+    OBJECT_POOL_ATOMIC(uint64_t) *slot = large_entry_of(pool, ptr);
+    return slot ? (size_t)(atomic_load_explicit(slot, memory_order_acquire) >> 1) : 0;
+}
+
+// Destroys every class pool and the allocator
+void size_class_pool_destroy(SizeClassPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("size_class_pool_destroy received NULL pool pointer.");
+        return;
+    }
+
+    for (size_t i = 0; i < pool->class_count; i++)
+    {
+        ObjectPool *class = atomic_load_explicit(&pool->classes[i], memory_order_relaxed);
+        if (class)
+        {
+            object_pool_destroy(class);
+        }
+    }
+
+    for (size_t i = 0; i < ROOT_ENTRIES; i++)
+    {
+        free(atomic_load_explicit(&pool->page_map[i], memory_order_relaxed));
+    }
+    free(pool->page_map);
+
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+    LOG_INFO("Size class pool destroyed.");
+}
@@ -0,0 +1,199 @@
+#include "soa_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include "cli_logger.h"
+#include "lf_stack.h"
+
+// Helper to round a size up to a power-of-two alignment
+#define ALIGN_UP(value, alignment) (((value) + (alignment) - 1) & ~((size_t)(alignment) - 1))
+
+// Initializes the pool from a schema of field sizes
+bool soa_pool_init(SoaPool **pool_ptr, size_t capacity, const size_t *field_sizes, size_t field_count)
+{
+    if (!pool_ptr || capacity == 0 || capacity >= LF_NIL || !field_sizes || field_count == 0 ||
+        field_count > SOA_POOL_MAX_FIELDS)
+    {
+        LOG_ERROR("Invalid parameters for soa_pool_init.");
+        return false;
+    }
+
+    // Lay the columns out back to back, each starting on its own cache line
+    size_t offsets[SOA_POOL_MAX_FIELDS];
+    size_t total = 0;
+    for (size_t i = 0; i < field_count; i++)
+    {
+        if (field_sizes[i] == 0 || field_sizes[i] > (SIZE_MAX - total - SOA_POOL_COLUMN_ALIGNMENT) / capacity)
+        {
+            LOG_ERROR("Field %zu of the schema has an invalid size.", i);
+            return false;
+        }
+        offsets[i] = total;
+        total += ALIGN_UP(capacity * field_sizes[i], SOA_POOL_COLUMN_ALIGNMENT);
+    }
+
+    SoaPool *pool = calloc(1, sizeof(SoaPool));
+    if (!pool)
+    {
+        LOG_ERROR("Failed to allocate memory for SoaPool.");
+        return false;
+    }
+
+    pool->memory = aligned_alloc(SOA_POOL_COLUMN_ALIGNMENT, total);
+    pool->free_next = malloc(capacity * sizeof(*pool->free_next));
+    pool->acquired_bitmap = calloc(BITMAP_WORDS(capacity), sizeof(*pool->acquired_bitmap));
+    if (!pool->memory || !pool->free_next || !pool->acquired_bitmap)
+    {
+        LOG_ERROR("Failed to allocate memory for SoaPool columns.");
+        soa_pool_destroy(pool);
+        return false;
+    }
+
+    pool->field_count = field_count;
+    pool->capacity = capacity;
+    for (size_t i = 0; i < field_count; i++)
+    {
+        pool->columns[i] = pool->memory + offsets[i];
+        pool->field_sizes[i] = field_sizes[i];
+    }
+    for (size_t i = 0; i < capacity; i++)
+    {
+        atomic_init(&pool->free_next[i], i + 1 < capacity ? (uint32_t)(i + 1) : LF_NIL);
+    }
+    atomic_init(&pool->free_head, LF_HEAD(0, 0));
+    atomic_init(&pool->available, capacity);
+
+    LOG_INFO("SoA pool initialized with %zu records of %zu fields.", capacity, field_count);
+    *pool_ptr = pool;
+    return true;
+}
+
+// Acquires a record from the free stack
+size_t soa_pool_acquire(SoaPool *pool)
+{
+    if (!pool)
+    {
+        LOG_ERROR("soa_pool_acquire received NULL pool pointer.");
+        return OBJECT_POOL_INVALID_INDEX;
+    }
+
+    uint32_t index = lf_stack_pop(&pool->free_head, lf_array_link, pool->free_next);
+    if (index == LF_NIL)
+    {
+        LOG_WARNING("SoA pool is empty. Cannot acquire record.");
+        return OBJECT_POOL_INVALID_INDEX;
+    }
+
+    atomic_fetch_sub_explicit(&pool->available, 1, memory_order_relaxed);
+    atomic_fetch_or_explicit(&pool->acquired_bitmap[BITMAP_WORD(index)], BITMAP_BIT(index), memory_order_relaxed);
+    return index;
+}
+
+// Releases a record to the free stack
+void soa_pool_release(SoaPool *pool, size_t index)
+{
+    if (!pool)
+    {
+        LOG_ERROR("soa_pool_release received NULL pool pointer.");
+        return;
+    }
+
+    uint64_t bit = 0;
+    if (index < pool->capacity)
+    {
+        bit = BITMAP_BIT(index);
+        bit &= atomic_fetch_and_explicit(&pool->acquired_bitmap[BITMAP_WORD(index)], ~bit, memory_order_relaxed);
+    }
+    if (!bit)
+    {
+        LOG_WARNING("Attempted to release a record not acquired from the SoA pool.");
+        return;
+    }
+
+    lf_stack_push_chain(&pool->free_head, (uint32_t)index, &pool->free_next[index]);
+    atomic_fetch_add_explicit(&pool->available, 1, memory_order_relaxed);
+}
+
+// Returns the column of one field
+void *soa_pool_column(SoaPool *pool, size_t field)
+{
+    return pool && field < pool->field_count ? pool->columns[field] : NULL;
+}
+
+// Returns one field of one record
+void *soa_pool_field(SoaPool *pool, size_t index, size_t field)
+{
+    if (!pool || field >= pool->field_count || index >= pool->capacity)
+    {
+        return NULL;
+    }
+    return pool->columns[field] + index * pool->field_sizes[field];
+}
+
+// Visits every maximal run of consecutive live slots
+size_t soa_pool_iterate(SoaPool *pool, soa_run_callback callback, void *user_data)
+{
+    if (!pool || !callback)
+    {
+        LOG_ERROR("soa_pool_iterate received NULL pool or callback.");
+        return 0;
+    }
+
+    size_t visited = 0;
+    size_t run_first = 0;
+    size_t run_count = 0;
+    for (size_t word = 0; word < BITMAP_WORDS(pool->capacity); word++)
+    {
+        uint64_t bits = atomic_load_explicit(&pool->acquired_bitmap[word], memory_order_relaxed);
+        while (bits)
+        {
+            // Bits below start are already clear, so the run is the block of ones starting there
+            size_t start = (size_t)__builtin_ctzll(bits);
+            uint64_t shifted = bits >> start;
+            size_t length = ~shifted == 0 ? 64 - start : (size_t)__builtin_ctzll(~shifted);
+            size_t first = word * 64 + start;
+
+            if (run_count > 0 && run_first + run_count == first)
+            {
+                run_count += length;
+            }
+            else
+            {
+                if (run_count > 0)
+                {
+                    callback(pool, run_first, run_count, user_data);
+                }
+                run_first = first;
+                run_count = length;
+            }
+            visited += length;
+            bits = start + length >= 64 ? 0 : bits & (~0ull << (start + length));
+        }
+    }
+
+    if (run_count > 0)
+    {
+        callback(pool, run_first, run_count, user_data);
+    }
+    return visited;
+}
+
+// Returns the number of free records
+size_t soa_pool_available(const SoaPool *pool)
+{
+    return pool ? atomic_load_explicit(&pool->available, memory_order_relaxed) : 0;
+}
+
+// Frees the pool and its columns
+void soa_pool_destroy(SoaPool *pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    free(pool->memory);
+    free(pool->free_next);
+    free(pool->acquired_bitmap);
+    free(pool);
+    LOG_INFO("SoA pool destroyed.");
+}
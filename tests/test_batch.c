@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define OBJECT_COUNT 100
+#define BATCH_SIZE 64
+
+// Runs the batch API against a pool built from the given configuration
+static void run_batch_test(ObjectPoolConfig config)
+{
+    ObjectPool *pool = NULL;
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(long);
+    assert(object_pool_init_ex(&pool, &config));
+
+    void *first[BATCH_SIZE];
+    void *second[BATCH_SIZE];
+
+    // Batches grow the pool up to max_size when a growth policy is set
+    if (config.growth != OBJECT_POOL_GROWTH_NONE)
+    {
+        void *grown[OBJECT_COUNT * 2];
+        assert(object_pool_acquire_n(pool, grown, OBJECT_COUNT * 2) == OBJECT_COUNT * 2);
+        assert(object_pool_acquire(pool) == NULL);
+        assert(object_pool_release_n(pool, grown, OBJECT_COUNT * 2) == OBJECT_COUNT * 2);
+        object_pool_destroy(pool);
+        return;
+    }
+
+    // A full batch, then a partial one when the pool runs dry
+    assert(object_pool_acquire_n(pool, first, BATCH_SIZE) == BATCH_SIZE);
+    assert(object_pool_acquire_n(pool, second, OBJECT_COUNT) == OBJECT_COUNT - BATCH_SIZE);
+    assert(object_pool_acquire(pool) == NULL);
+
+    // Every object is distinct and writable
+    for (int i = 0; i < BATCH_SIZE; ++i)
+    {
+        *(long *)first[i] = i;
+    }
+    for (int i = 0; i < OBJECT_COUNT - BATCH_SIZE; ++i)
+    {
+        *(long *)second[i] = BATCH_SIZE + i;
+    }
+    for (int i = 0; i < BATCH_SIZE; ++i)
+    {
+        assert(*(long *)first[i] == i);
+    }
+
+    // Releasing the same batch twice only counts once
+    assert(object_pool_release_n(pool, first, BATCH_SIZE) == BATCH_SIZE);
+    assert(object_pool_release_n(pool, first, BATCH_SIZE) == 0);
+    assert(object_pool_release_n(pool, second, OBJECT_COUNT - BATCH_SIZE) == OBJECT_COUNT - BATCH_SIZE);
+
+    object_pool_thread_cache_flush(pool);
+    assert(pool->available == OBJECT_COUNT);
+
+    object_pool_destroy(pool);
+}
+
+int main()
+{
+    ObjectPoolConfig config = {0};
+    run_batch_test(config);
+
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    run_batch_test(config);
+
+    config.mode = OBJECT_POOL_MODE_MUTEX;
+    config.thread_cache_size = 16;
+    run_batch_test(config);
+
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    config.growth = OBJECT_POOL_GROWTH_GEOMETRIC;
+    config.max_size = OBJECT_COUNT * 2;
+    run_batch_test(config);
+
+    printf("[INFO]: All batch tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define CHUNK_SIZE 200
+#define POOL_SIZE 1000
+#define OBJECT_SIZE 24
+#define HELD_BYTE 0x5A
+#define FILL_BYTE 0xAB
+
+static void *objects[POOL_SIZE];
+static bool held[POOL_SIZE];
+
+// Accepts held objects marked with an odd byte
+static bool first_byte_odd(const void *object, void *user_data)
+{
+    (void)user_data;
+    return ((const unsigned char *)object)[0] & 1;
+}
+
+// Reference answer for object_pool_find_free
+static size_t naive_find_free(size_t from)
+{
+    for (size_t i = from; i < POOL_SIZE; i++)
+    {
+        if (!held[i])
+        {
+            return i;
+        }
+    }
+    return OBJECT_POOL_INVALID_INDEX;
+}
+
+#ifndef OBJECT_POOL_DEBUG
+// Checks that every slot byte matches its expected value
+static bool slot_filled(ObjectPool *pool, size_t index, unsigned char value)
+{
+    const unsigned char *bytes = object_pool_at(pool, index);
+    for (size_t i = 0; i < OBJECT_SIZE; i++)
+    {
+        if (bytes[i] != value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+// Always succeeds; only there to make the pool track construction
+static bool construct(void *object, void *user_data)
+{
+    (void)object;
+    (void)user_data;
+    return true;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    const char *kernel = object_pool_simd_kernel();
+    assert(strcmp(kernel, "avx2") == 0 || strcmp(kernel, "sse4.1") == 0 || strcmp(kernel, "scalar") == 0);
+
+    // Five chunks, so scans cross chunk boundaries
+    ObjectPoolConfig config = {0};
+    config.initial_size = CHUNK_SIZE;
+    config.object_size = OBJECT_SIZE;
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    config.max_size = POOL_SIZE;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+    for (size_t i = 0; i < POOL_SIZE; i++)
+    {
+        void *object = object_pool_acquire(pool);
+        assert(object != NULL);
+        size_t index = object_pool_index_of(pool, object);
+        objects[index] = object;
+        held[index] = true;
+    }
+    assert(object_pool_find_free(pool, 0) == OBJECT_POOL_INVALID_INDEX);
+
+    // Release a pattern with long full stretches, long empty stretches and scattered holes
+    unsigned seed = 12345;
+    for (size_t i = 0; i < POOL_SIZE; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        bool release = (i >= 130 && i < 420) || (i >= 700 && (seed >> 16) % 7 == 0) || i == 999;
+        if (release)
+        {
+            object_pool_release(pool, objects[i]);
+            held[i] = false;
+        }
+        else
+        {
+            memset(objects[i], HELD_BYTE | (unsigned char)(i & 1), OBJECT_SIZE);
+        }
+    }
+
+    // find_free agrees with a linear scan from every starting point
+    for (size_t from = 0; from <= POOL_SIZE; from++)
+    {
+        assert(object_pool_find_free(pool, from) == naive_find_free(from));
+    }
+
+    // count_if visits exactly the held objects
+    size_t held_count = 0;
+    size_t odd_count = 0;
+    for (size_t i = 0; i < POOL_SIZE; i++)
+    {
+        held_count += held[i];
+        odd_count += held[i] && (i & 1);
+    }
+    assert(object_pool_count_if(pool, first_byte_odd, NULL) == odd_count);
+    assert(held_count == POOL_SIZE - pool->available);
+
+    // Filling a range touches only its free slots
+#ifndef OBJECT_POOL_DEBUG
+    size_t expected = 0;
+    for (size_t i = 100; i < 750; i++)
+    {
+        expected += !held[i];
+    }
+    assert(object_pool_fill_free(pool, 100, 650, FILL_BYTE) == expected);
+    for (size_t i = 0; i < POOL_SIZE; i++)
+    {
+        if (held[i])
+        {
+            assert(slot_filled(pool, i, HELD_BYTE | (unsigned char)(i & 1)));
+        }
+        else if (i >= 100 && i < 750)
+        {
+            assert(slot_filled(pool, i, FILL_BYTE));
+        }
+    }
+
+    // Zeroing the rest of the pool reaches the last slot
+    assert(object_pool_fill_free(pool, 0, SIZE_MAX, 0) == POOL_SIZE - held_count);
+    assert(slot_filled(pool, 999, 0));
+    assert(slot_filled(pool, 130, 0));
+#else
+    // Free slots carry poison in debug builds and are left alone
+    assert(object_pool_fill_free(pool, 0, SIZE_MAX, 0) == 0);
+#endif
+
+    object_pool_destroy(pool);
+
+    // Pools whose free slots hold constructed objects are not filled
+    config = (ObjectPoolConfig){0};
+    config.initial_size = CHUNK_SIZE;
+    config.object_size = OBJECT_SIZE;
+    config.constructor = construct;
+    assert(object_pool_init_ex(&pool, &config));
+    assert(object_pool_fill_free(pool, 0, SIZE_MAX, 0) == 0);
+    assert(object_pool_find_free(pool, 0) == 0);
+    object_pool_destroy(pool);
+
+    printf("Bitmap scan test passed.\n");
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define CHUNK_SIZE 64
+#define CHUNKS 4
+#define BIG_CHUNK_SIZE 256
+
+typedef struct
+{
+    int id;
+    int payload[3];
+} Node;
+
+static Node *refs[3 * BIG_CHUNK_SIZE];
+
+// Repoints the reference table at a moved node
+static void relocate(void *old_object, void *new_object, void *user_data)
+{
+    Node *node = new_object;
+    assert(refs[node->id] == old_object);
+    refs[node->id] = node;
+    (*(int *)user_data)++;
+}
+
+// Counts constructions and destructions through hook_data
+static bool construct(void *object, void *user_data)
+{
+    (void)object;
+    ((int *)user_data)[0]++;
+    return true;
+}
+
+static void destruct(void *object, void *user_data)
+{
+    (void)object;
+    ((int *)user_data)[1]++;
+}
+
+// Acquires count nodes numbered by acquisition order
+static void acquire_nodes(ObjectPool *pool, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        refs[i] = object_pool_acquire(pool);
+        assert(refs[i] != NULL);
+        refs[i]->id = (int)i;
+        for (int j = 0; j < 3; j++)
+        {
+            refs[i]->payload[j] = (int)i * 3 + j;
+        }
+    }
+}
+
+// Checks that every surviving node kept its contents
+static void check_nodes(ObjectPool *pool, size_t count, size_t keep_every)
+{
+    for (size_t i = 0; i < count; i += keep_every)
+    {
+        assert(refs[i]->id == (int)i);
+        assert(object_pool_index_of(pool, refs[i]) != OBJECT_POOL_INVALID_INDEX);
+        for (int j = 0; j < 3; j++)
+        {
+            assert(refs[i]->payload[j] == (int)i * 3 + j);
+        }
+    }
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    ObjectPoolConfig config = {0};
+    config.initial_size = CHUNK_SIZE;
+    config.object_size = sizeof(Node);
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+
+    // A few survivors scattered over four chunks all fit in the first one
+    acquire_nodes(pool, CHUNKS * CHUNK_SIZE);
+    assert(pool->pool_size == CHUNKS * CHUNK_SIZE);
+    for (size_t i = 0; i < CHUNKS * CHUNK_SIZE; i++)
+    {
+        if (i % 16 != 0)
+        {
+            object_pool_release(pool, refs[i]);
+        }
+    }
+    int moves = 0;
+    assert(object_pool_compact(pool, relocate, &moves, 0) == 12);
+    assert(moves == 12);
+    assert(pool->pool_size == CHUNK_SIZE);
+    check_nodes(pool, CHUNKS * CHUNK_SIZE, 16);
+    for (size_t i = 0; i < CHUNKS * CHUNK_SIZE; i += 16)
+    {
+        assert(object_pool_index_of(pool, refs[i]) < CHUNK_SIZE);
+    }
+    ObjectPoolStats stats;
+    assert(object_pool_get_stats(pool, &stats));
+    assert(stats.shrinks == CHUNKS - 1 && stats.relocations == 12);
+    assert(stats.available == CHUNK_SIZE - 16);
+
+    // Nothing is left to do, and the pool still grows back into the freed chunks
+    assert(object_pool_compact(pool, relocate, &moves, 0) == 0);
+    for (size_t i = 0; i < CHUNKS * CHUNK_SIZE; i += 16)
+    {
+        object_pool_release(pool, refs[i]);
+    }
+    acquire_nodes(pool, 2 * CHUNK_SIZE);
+    assert(pool->pool_size == 2 * CHUNK_SIZE);
+    object_pool_destroy(pool);
+
+    // Tight budgets make progress a batch at a time and stop where no chunk can be freed
+    config.initial_size = BIG_CHUNK_SIZE;
+    assert(object_pool_init_ex(&pool, &config));
+    acquire_nodes(pool, 3 * BIG_CHUNK_SIZE);
+    for (size_t i = 0; i < 3 * BIG_CHUNK_SIZE; i++)
+    {
+        size_t local = i % BIG_CHUNK_SIZE;
+        if ((i < BIG_CHUNK_SIZE && local < 200) || (i >= BIG_CHUNK_SIZE && local >= 150))
+        {
+            object_pool_release(pool, refs[i]);
+            refs[i] = NULL;
+        }
+    }
+    size_t total = 0;
+    size_t calls = 0;
+    size_t step;
+    while ((step = object_pool_compact(pool, relocate, &moves, 1)) > 0)
+    {
+        total += step;
+        calls++;
+    }
+    assert(total == 150 && calls >= 1);
+    assert(pool->pool_size == 2 * BIG_CHUNK_SIZE);
+    for (size_t i = 0; i < 3 * BIG_CHUNK_SIZE; i++)
+    {
+        if (refs[i])
+        {
+            assert(refs[i]->id == (int)i);
+            assert(object_pool_index_of(pool, refs[i]) < 2 * BIG_CHUNK_SIZE);
+        }
+    }
+    object_pool_destroy(pool);
+
+    // Objects overwritten by a move are destroyed, and moved ones destroyed exactly once
+    int counts[2] = {0, 0};
+    config.initial_size = CHUNK_SIZE;
+    config.constructor = construct;
+    config.destructor = destruct;
+    config.hook_data = counts;
+    assert(object_pool_init_ex(&pool, &config));
+    acquire_nodes(pool, 2 * CHUNK_SIZE);
+    for (size_t i = 0; i < 2 * CHUNK_SIZE; i++)
+    {
+        if (i % 8 != 0)
+        {
+            object_pool_release(pool, refs[i]);
+        }
+    }
+    assert(object_pool_compact(pool, relocate, &moves, 0) == CHUNK_SIZE / 8);
+    assert(counts[1] == CHUNK_SIZE / 8 + CHUNK_SIZE - CHUNK_SIZE / 8);
+    check_nodes(pool, 2 * CHUNK_SIZE, 8);
+    object_pool_destroy(pool);
+    assert(counts[0] == 2 * CHUNK_SIZE && counts[1] == counts[0]);
+
+    // Lock-free pools cannot be compacted
+    config = (ObjectPoolConfig){0};
+    config.initial_size = CHUNK_SIZE;
+    config.object_size = sizeof(Node);
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    assert(object_pool_init_ex(&pool, &config));
+    assert(object_pool_compact(pool, relocate, &moves, 0) == 0);
+    assert(object_pool_compact(pool, NULL, NULL, 0) == 0);
+    object_pool_destroy(pool);
+
+    printf("Compaction test passed.\n");
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "object_pool.hpp"
+#include "cli_logger.h"
+
+#define OBJECT_COUNT 4
+#define THREAD_COUNT 8
+#define ITERATIONS 2000
+
+// Tracks live instances so leaks and double destruction show up in the counts
+struct Tracked
+{
+    static std::atomic<int> live;
+
+    std::string name;
+    int value;
+
+    Tracked(std::string name_in, int value_in) : name(std::move(name_in)), value(value_in)
+    {
+        if (value < 0)
+        {
+            throw std::invalid_argument("negative value");
+        }
+        live++;
+    }
+
+    ~Tracked()
+    {
+        live--;
+    }
+};
+
+std::atomic<int> Tracked::live(0);
+
+struct alignas(64) CacheLine
+{
+    std::uint64_t counter;
+};
+
+using TrackedPool = object_pool::ObjectPool<Tracked, OBJECT_COUNT>;
+
+static_assert(TrackedPool::capacity == OBJECT_COUNT, "capacity is a compile-time constant");
+static_assert(TrackedPool::object_size == sizeof(Tracked), "object size comes from T");
+static_assert(std::is_same<TrackedPool::handle::element_type, Tracked>::value, "handles are typed");
+
+static void worker(TrackedPool &pool, int id)
+{
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        auto handle = pool.emplace_wait("worker", id);
+        assert(handle && handle->value == id);
+    }
+}
+
+int main()
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    {
+        TrackedPool pool;
+        assert(pool.available() == OBJECT_COUNT);
+
+        // Perfect forwarding: the string is moved into the object
+        std::string name(64, 'x');
+        auto handle = pool.emplace(std::move(name), 7);
+        assert(handle);
+        assert(handle->name.size() == 64 && handle->value == 7);
+        assert(Tracked::live == 1 && pool.available() == OBJECT_COUNT - 1);
+
+        // Handles return their object when they go out of scope
+        handle.reset();
+        assert(Tracked::live == 0 && pool.available() == OBJECT_COUNT);
+
+        // Exhaustion yields an empty handle; the timed variant gives up
+        std::vector<TrackedPool::handle> held;
+        for (int i = 0; i < OBJECT_COUNT; i++)
+        {
+            held.push_back(pool.emplace("held", i));
+            assert(held.back());
+        }
+        assert(!pool.emplace("extra", 0));
+        assert(!pool.emplace_for(10, "extra", 0));
+
+        // Moving a handle transfers ownership without touching the pool
+        TrackedPool::handle moved = std::move(held.back());
+        held.pop_back();
+        assert(Tracked::live == OBJECT_COUNT && pool.available() == 0);
+        moved.reset();
+        assert(pool.available() == 1);
+        held.clear();
+        assert(Tracked::live == 0 && pool.available() == OBJECT_COUNT);
+
+        // A throwing constructor releases the slot, and handles release during unwinding
+        bool thrown = false;
+        try
+        {
+            auto first = pool.emplace("first", 1);
+            assert(pool.available() == OBJECT_COUNT - 1);
+            pool.emplace("bad", -1);
+        }
+        catch (const std::invalid_argument &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(Tracked::live == 0 && pool.available() == OBJECT_COUNT);
+
+        // Objects detached from their handle can be returned with destroy()
+        Tracked *raw = pool.emplace("raw", 3).release();
+        assert(raw != nullptr && Tracked::live == 1);
+        pool.destroy(raw);
+        assert(Tracked::live == 0 && pool.available() == OBJECT_COUNT);
+    }
+
+    {
+        // Over-aligned types get aligned slots
+        object_pool::ObjectPool<CacheLine, 8> pool;
+        std::vector<object_pool::ObjectPool<CacheLine, 8>::handle> lines;
+        for (int i = 0; i < 8; i++)
+        {
+            lines.push_back(pool.emplace(CacheLine{0}));
+            assert(reinterpret_cast<std::uintptr_t>(lines.back().get()) % alignof(CacheLine) == 0);
+        }
+    }
+
+    {
+        // Blocking emplace from several threads sharing a lock-free pool
+        ObjectPoolConfig config = ObjectPoolConfig();
+        config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+        TrackedPool pool(config);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREAD_COUNT; t++)
+        {
+            threads.emplace_back(worker, std::ref(pool), t);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        ObjectPoolStats stats;
+        assert(object_pool_get_stats(pool.native(), &stats));
+        assert(stats.acquires == stats.releases);
+        assert(Tracked::live == 0 && pool.available() == OBJECT_COUNT);
+    }
+
+    {
+        // With a thread cache, released slots are reused inline without reaching the C pool
+        ObjectPoolConfig config = ObjectPoolConfig();
+        config.thread_cache_size = 4;
+        object_pool::ObjectPool<Tracked, 16> pool(config);
+
+        Tracked *first = pool.emplace("cached", 1).release();
+        assert(pool.available() == 14);
+        ObjectPoolStats before;
+        assert(object_pool_get_stats(pool.native(), &before));
+        pool.destroy(first);
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            auto handle = pool.emplace("cached", i);
+            assert(handle.get() == first && handle->value == i);
+        }
+        ObjectPoolStats after;
+        assert(object_pool_get_stats(pool.native(), &after));
+        assert(after.acquires == before.acquires && after.releases == before.releases);
+        assert(Tracked::live == 0);
+
+        // A full cache spills half its slots back to the C pool
+        std::vector<Tracked *> raw;
+        for (int i = 0; i < 8; i++)
+        {
+            raw.push_back(pool.emplace("spill", i).release());
+        }
+        for (Tracked *object : raw)
+        {
+            pool.destroy(object);
+        }
+        assert(pool.available() > 8 && pool.available() <= 12);
+
+        // Blocking emplace from threads with their own caches on a pool smaller than the thread count
+        TrackedPool small(config);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREAD_COUNT; t++)
+        {
+            threads.emplace_back(worker, std::ref(small), t);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        // Exiting threads flushed their caches back to the C pool
+        ObjectPoolStats stats;
+        assert(object_pool_get_stats(small.native(), &stats));
+        assert(stats.acquires == stats.releases && small.available() == OBJECT_COUNT);
+        assert(Tracked::live == 0);
+    }
+
+    printf("C++ wrapper test passed.\n");
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/asan_interface.h>
+#endif
+
+#define POOL_SIZE 8
+
+typedef struct
+{
+    int id;
+    char name[20];
+} Record;
+
+// Helper function to read the pool's corruption counter
+static uint64_t corruptions(ObjectPool *pool)
+{
+    ObjectPoolStats stats;
+    assert(object_pool_get_stats(pool, &stats));
+    return stats.corruptions;
+}
+
+#ifdef OBJECT_POOL_DEBUG
+// Runs the debug checks against one pool configuration
+static void check_mode(ObjectPoolMode mode, size_t thread_cache_size)
+{
+    ObjectPoolConfig config = {0};
+    config.initial_size = POOL_SIZE;
+    config.object_size = sizeof(Record);
+    config.mode = mode;
+    config.thread_cache_size = thread_cache_size;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+
+    // Each slot carries a red zone past the object
+    assert(pool->stride > pool->object_size);
+
+    // Well-behaved use is never reported
+    Record *record = object_pool_acquire(pool);
+    assert(record != NULL);
+    memset(record, 0, sizeof(*record));
+    object_pool_release(pool, record);
+    assert(corruptions(pool) == 0);
+
+    // A second release of the same object is caught by its slot state
+    record = object_pool_acquire(pool);
+    object_pool_release(pool, record);
+    object_pool_release(pool, record);
+    assert(corruptions(pool) == 1);
+
+#ifdef __SANITIZE_ADDRESS__
+    // Free objects and red zones are unaddressable; acquired objects are not
+    assert(__asan_address_is_poisoned(record));
+    record = object_pool_acquire(pool);
+    assert(!__asan_address_is_poisoned(record));
+    assert(__asan_address_is_poisoned((char *)record + sizeof(*record)));
+    object_pool_release(pool, record);
+#else
+    // Writing one byte past the object lands in the red zone and is reported on release
+    record = object_pool_acquire(pool);
+    ((char *)record)[sizeof(*record)] = 'x';
+    object_pool_release(pool, record);
+    assert(corruptions(pool) == 2);
+
+    // Released objects are poisoned, and a write after release is reported on the next acquire
+    assert(record->id == (int)0xDDDDDDDD);
+    record->id = 42;
+    Record *again = object_pool_acquire(pool);
+    assert(again == record);
+    assert(corruptions(pool) == 3);
+    object_pool_release(pool, again);
+#endif
+
+    object_pool_destroy(pool);
+}
+
+// Constructed objects keep their state while free, so only their red zones are checked
+static bool construct_record(void *object, void *user_data)
+{
+    (void)user_data;
+    Record *record = object;
+    record->id = 7;
+    return true;
+}
+#endif
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+#ifdef OBJECT_POOL_DEBUG
+    check_mode(OBJECT_POOL_MODE_MUTEX, 0);
+    check_mode(OBJECT_POOL_MODE_LOCK_FREE, 0);
+    check_mode(OBJECT_POOL_MODE_MUTEX, 4);
+
+    ObjectPoolConfig config = {0};
+    config.initial_size = POOL_SIZE;
+    config.object_size = sizeof(Record);
+    config.constructor = construct_record;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+    Record *record = object_pool_acquire(pool);
+    assert(record->id == 7);
+    object_pool_release(pool, record);
+    record = object_pool_acquire(pool);
+    assert(record->id == 7);
+    object_pool_release(pool, record);
+    assert(corruptions(pool) == 0);
+    object_pool_destroy(pool);
+
+    printf("Debug checks test passed.\n");
+#else
+    // Release builds add no padding and count nothing
+    ObjectPool *pool = NULL;
+    assert(object_pool_init(&pool, POOL_SIZE, sizeof(Record)));
+    assert(pool->stride == sizeof(Record));
+    void *record = object_pool_acquire(pool);
+    object_pool_release(pool, record);
+    object_pool_release(pool, record);
+    assert(corruptions(pool) == 0);
+    object_pool_destroy(pool);
+
+    printf("Debug checks test skipped (build with make DEBUG=1).\n");
+#endif
+    return 0;
+}
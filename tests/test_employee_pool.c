@@ -92,8 +92,8 @@ int main()
             }
             if (release_index != -1)
             {
+                log_info("Releasing Employee ID: %d, Name: %s", employees[release_index]->id, employees[release_index]->name);
                 object_pool_release(pool, employees[release_index]);
-                log_info("Released Employee ID: %d, Name: %s", employees[release_index]->id, employees[release_index]->name);
                 employees[release_index] = NULL;
             }
             else
@@ -144,8 +144,8 @@ int main()
     {
         if (employees[i] != NULL)
         {
+            log_info("Releasing Employee ID: %d, Name: %s", employees[i]->id, employees[i]->name);
             object_pool_release(pool, employees[i]);
-            log_info("Released Employee ID: %d, Name: %s", employees[i]->id, employees[i]->name);
             employees[i] = NULL;
         }
     }
@@ -0,0 +1,204 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <assert.h>
+#include <time.h>
+#include <pthread.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define INITIAL_SIZE 4
+#define MAX_SIZE 16
+#define NUM_THREADS 4
+#define CONTENDED_GROWTH_STEP 64
+#define CONTENDED_MAX_SIZE (INITIAL_SIZE + 32 * CONTENDED_GROWTH_STEP)
+
+// Sleeps for the given number of milliseconds
+static void sleep_ms(long ms)
+{
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+// Geometric growth doubles the pool until max_size is reached
+static void test_geometric_growth(void)
+{
+    ObjectPool *pool = NULL;
+    ObjectPoolConfig config = {0};
+    config.initial_size = INITIAL_SIZE;
+    config.object_size = sizeof(int);
+    config.growth = OBJECT_POOL_GROWTH_GEOMETRIC;
+    config.max_size = MAX_SIZE;
+    assert(object_pool_init_ex(&pool, &config));
+
+    int *objects[MAX_SIZE];
+    for (int i = 0; i < MAX_SIZE; ++i)
+    {
+        objects[i] = (int *)object_pool_acquire(pool);
+        assert(objects[i] != NULL);
+        *objects[i] = i;
+    }
+    assert(pool->pool_size == MAX_SIZE);
+    assert(object_pool_acquire(pool) == NULL);
+
+    // Earlier objects were not moved by growth
+    for (int i = 0; i < MAX_SIZE; ++i)
+    {
+        assert(*objects[i] == i);
+        object_pool_release(pool, objects[i]);
+    }
+
+    // Every grown chunk is idle now; the initial one is kept
+    assert(object_pool_shrink(pool) == MAX_SIZE - INITIAL_SIZE);
+    assert(pool->pool_size == INITIAL_SIZE);
+    assert(pool->available == INITIAL_SIZE);
+
+    // Freed chunks are reused when the pool grows again
+    for (int i = 0; i < INITIAL_SIZE + 1; ++i)
+    {
+        objects[i] = (int *)object_pool_acquire(pool);
+        assert(objects[i] != NULL);
+    }
+    assert(pool->pool_size == INITIAL_SIZE * 2);
+    for (int i = 0; i < INITIAL_SIZE + 1; ++i)
+    {
+        object_pool_release(pool, objects[i]);
+    }
+
+    object_pool_destroy(pool);
+}
+
+// Linear growth in lock-free mode adds growth_step objects at a time
+static void test_linear_growth_lock_free(void)
+{
+    ObjectPool *pool = NULL;
+    ObjectPoolConfig config = {0};
+    config.initial_size = INITIAL_SIZE;
+    config.object_size = sizeof(int);
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    config.growth_step = 3;
+    assert(object_pool_init_ex(&pool, &config));
+
+    void *objects[INITIAL_SIZE + 1];
+    for (int i = 0; i < INITIAL_SIZE + 1; ++i)
+    {
+        objects[i] = object_pool_acquire(pool);
+        assert(objects[i] != NULL);
+    }
+    assert(pool->pool_size == INITIAL_SIZE + 3);
+    for (int i = 0; i < INITIAL_SIZE + 1; ++i)
+    {
+        object_pool_release(pool, objects[i]);
+    }
+    assert(pool->available == INITIAL_SIZE + 3);
+
+    object_pool_destroy(pool);
+}
+
+typedef struct
+{
+    ObjectPool *pool;
+    size_t count;
+    void *objects[CONTENDED_MAX_SIZE];
+} Drainer;
+
+static Drainer drainers[NUM_THREADS];
+
+// Acquires from a shared pool until it is exhausted
+static void *drain_pool(void *arg)
+{
+    Drainer *drainer = arg;
+    void *obj;
+    while ((obj = object_pool_acquire(drainer->pool)) != NULL)
+    {
+        drainer->objects[drainer->count++] = obj;
+    }
+    return NULL;
+}
+
+// Threads racing to grow a lock-free pool take exactly max_size objects and all see it run dry
+static void test_contended_growth_lock_free(void)
+{
+    ObjectPool *pool = NULL;
+    ObjectPoolConfig config = {0};
+    config.initial_size = INITIAL_SIZE;
+    config.object_size = sizeof(int);
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    config.growth_step = CONTENDED_GROWTH_STEP;
+    config.max_size = CONTENDED_MAX_SIZE;
+    assert(object_pool_init_ex(&pool, &config));
+
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        drainers[i].pool = pool;
+        assert(pthread_create(&threads[i], NULL, drain_pool, &drainers[i]) == 0);
+    }
+    size_t total = 0;
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        total += drainers[i].count;
+    }
+    assert(total == CONTENDED_MAX_SIZE);
+    assert(pool->pool_size == CONTENDED_MAX_SIZE);
+    assert(pool->available == 0);
+
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        for (size_t j = 0; j < drainers[i].count; ++j)
+        {
+            object_pool_release(pool, drainers[i].objects[j]);
+        }
+    }
+    assert(pool->available == CONTENDED_MAX_SIZE);
+
+    object_pool_destroy(pool);
+}
+
+// Grown chunks are freed once they stay idle for idle_shrink_ms
+static void test_idle_shrink(void)
+{
+    ObjectPool *pool = NULL;
+    ObjectPoolConfig config = {0};
+    config.initial_size = INITIAL_SIZE;
+    config.object_size = sizeof(int);
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    config.idle_shrink_ms = 20;
+    assert(object_pool_init_ex(&pool, &config));
+
+    void *objects[INITIAL_SIZE + 1];
+    for (int i = 0; i < INITIAL_SIZE + 1; ++i)
+    {
+        objects[i] = object_pool_acquire(pool);
+        assert(objects[i] != NULL);
+    }
+    assert(pool->pool_size == INITIAL_SIZE * 2);
+    for (int i = 0; i < INITIAL_SIZE + 1; ++i)
+    {
+        object_pool_release(pool, objects[i]);
+    }
+
+    // The chunk is first seen idle, then freed one threshold later
+    for (int i = 0; i < 3 && pool->pool_size > INITIAL_SIZE; ++i)
+    {
+        sleep_ms(25);
+        object_pool_release(pool, object_pool_acquire(pool));
+    }
+    assert(pool->pool_size == INITIAL_SIZE);
+    assert(pool->available == INITIAL_SIZE);
+
+    object_pool_destroy(pool);
+}
+
+int main()
+{
+    test_geometric_growth();
+    test_linear_growth_lock_free();
+    test_contended_growth_lock_free();
+    test_idle_shrink();
+
+    printf("[INFO]: All growth tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define POOL_SIZE 8
+#define SLOT_OF(handle) ((handle) & ((1u << OBJECT_POOL_HANDLE_INDEX_BITS) - 1))
+
+typedef struct
+{
+    int key;
+    int value;
+} Entry;
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+    assert(sizeof(ObjectPoolHandle) == 4);
+
+    ObjectPoolConfig config = {0};
+    config.initial_size = POOL_SIZE;
+    config.object_size = sizeof(Entry);
+    config.handles = true;
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+
+    // A handle resolves to its object until the object is released
+    ObjectPoolHandle handle = object_pool_acquire_handle(pool);
+    assert(handle != OBJECT_POOL_NULL_HANDLE);
+    Entry *entry = object_pool_resolve(pool, handle);
+    assert(entry != NULL);
+    entry->key = 1;
+    assert(object_pool_handle_of(pool, entry) == handle);
+    assert(object_pool_release_handle(pool, handle));
+    assert(object_pool_resolve(pool, handle) == NULL);
+    assert(!object_pool_release_handle(pool, handle));
+
+    // Reusing the slot gives a new handle; the old one stays stale
+    ObjectPoolHandle reused = object_pool_acquire_handle(pool);
+    assert(object_pool_resolve(pool, reused) == entry);
+    assert(reused != handle);
+    assert(SLOT_OF(reused) == SLOT_OF(handle));
+    assert(object_pool_resolve(pool, handle) == NULL);
+
+    // Releasing by pointer invalidates handles just the same
+    object_pool_release(pool, entry);
+    assert(object_pool_resolve(pool, reused) == NULL);
+
+    // Handles keep working in chunks added by growth
+    ObjectPoolHandle handles[2 * POOL_SIZE];
+    for (int i = 0; i < 2 * POOL_SIZE; i++)
+    {
+        handles[i] = object_pool_acquire_handle(pool);
+        assert(handles[i] != OBJECT_POOL_NULL_HANDLE);
+        Entry *e = object_pool_resolve(pool, handles[i]);
+        e->key = i;
+    }
+    assert(pool->pool_size == 2 * POOL_SIZE);
+    for (int i = 0; i < 2 * POOL_SIZE; i++)
+    {
+        assert(((Entry *)object_pool_resolve(pool, handles[i]))->key == i);
+        assert(object_pool_release_handle(pool, handles[i]));
+    }
+
+    // Null, out-of-range and foreign handles resolve to nothing
+    Entry foreign;
+    assert(object_pool_resolve(pool, OBJECT_POOL_NULL_HANDLE) == NULL);
+    assert(object_pool_resolve(pool, (1u << OBJECT_POOL_HANDLE_INDEX_BITS) | 1000) == NULL);
+    assert(object_pool_handle_of(pool, &foreign) == OBJECT_POOL_NULL_HANDLE);
+    assert(object_pool_handle_of(pool, entry) == OBJECT_POOL_NULL_HANDLE);
+    object_pool_destroy(pool);
+
+    // Pools without handles do not hand them out
+    assert(object_pool_init(&pool, POOL_SIZE, sizeof(Entry)));
+    assert(object_pool_acquire_handle(pool) == OBJECT_POOL_NULL_HANDLE);
+    assert(pool->available == POOL_SIZE);
+    object_pool_destroy(pool);
+
+    printf("Handle test passed.\n");
+    return 0;
+}
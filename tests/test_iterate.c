@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define POOL_SIZE 1000
+#define GROWTH_STEP 64
+
+typedef struct
+{
+    atomic_int visits;
+    int id;
+} Tracked;
+
+typedef struct
+{
+    ObjectPool *pool;
+    atomic_size_t count;
+    size_t shrunk;
+} WalkState;
+
+// Counts every visit; acquiring from the pool here would deadlock if the lock were held
+static void visit(void *object, void *user_data)
+{
+    WalkState *state = user_data;
+    Tracked *tracked = object;
+    atomic_fetch_add(&tracked->visits, 1);
+    atomic_fetch_add(&state->count, 1);
+
+    void *extra = object_pool_acquire(state->pool);
+    if (extra)
+    {
+        object_pool_release(state->pool, extra);
+    }
+}
+
+// Tries to shrink the pool while the snapshot pins its chunks
+static void try_shrink(void *object, void *user_data)
+{
+    (void)object;
+    WalkState *state = user_data;
+    state->shrunk += object_pool_shrink(state->pool);
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    ObjectPool *pool = NULL;
+    assert(object_pool_init(&pool, POOL_SIZE, sizeof(Tracked)));
+
+    Tracked *objects[POOL_SIZE];
+    for (int i = 0; i < POOL_SIZE; i++)
+    {
+        objects[i] = object_pool_acquire(pool);
+        assert(objects[i] != NULL);
+        atomic_init(&objects[i]->visits, 0);
+        objects[i]->id = i;
+    }
+
+    // Keep two thirds acquired
+    size_t held = 0;
+    for (int i = 0; i < POOL_SIZE; i++)
+    {
+        if (i % 3 == 0)
+        {
+            object_pool_release(pool, objects[i]);
+        }
+        else
+        {
+            held++;
+        }
+    }
+
+    // Serial snapshot: callbacks run with the lock released; released objects are not read,
+    // since debug builds poison them, and the count shows none of them was visited
+    WalkState state = {.pool = pool};
+    assert(object_pool_iterate_snapshot(pool, visit, &state) == held);
+    assert(atomic_load(&state.count) == held);
+    for (int i = 0; i < POOL_SIZE; i++)
+    {
+        if (i % 3 != 0)
+        {
+            assert(atomic_load(&objects[i]->visits) == 1);
+            atomic_store(&objects[i]->visits, 0);
+        }
+    }
+
+    // Parallel snapshot: every acquired object is visited exactly once across threads
+    for (size_t threads = 0; threads <= 8; threads += 4)
+    {
+        atomic_store(&state.count, 0);
+        assert(object_pool_iterate_parallel(pool, visit, &state, threads) == held);
+        assert(atomic_load(&state.count) == held);
+        for (int i = 0; i < POOL_SIZE; i++)
+        {
+            if (i % 3 != 0)
+            {
+                assert(atomic_load(&objects[i]->visits) == 1);
+                atomic_store(&objects[i]->visits, 0);
+            }
+        }
+    }
+
+    for (int i = 0; i < POOL_SIZE; i++)
+    {
+        if (i % 3 != 0)
+        {
+            object_pool_release(pool, objects[i]);
+        }
+    }
+    assert(object_pool_iterate_snapshot(pool, visit, &state) == 0);
+    object_pool_destroy(pool);
+
+    // A grown chunk stays allocated while a snapshot walk is in progress
+    ObjectPoolConfig config = {0};
+    config.initial_size = GROWTH_STEP;
+    config.object_size = sizeof(Tracked);
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    assert(object_pool_init_ex(&pool, &config));
+
+    void *grown[GROWTH_STEP + 1];
+    for (int i = 0; i <= GROWTH_STEP; i++)
+    {
+        grown[i] = object_pool_acquire(pool);
+        assert(grown[i] != NULL);
+    }
+    assert(pool->pool_size == 2 * GROWTH_STEP);
+
+    // Release everything but one object in the first chunk, so the grown chunk is idle
+    for (int i = 1; i <= GROWTH_STEP; i++)
+    {
+        object_pool_release(pool, grown[i]);
+    }
+    state.pool = pool;
+    state.shrunk = 0;
+    assert(object_pool_iterate_snapshot(pool, try_shrink, &state) == 1);
+    assert(state.shrunk == 0);
+    assert(object_pool_shrink(pool) == GROWTH_STEP);
+
+    object_pool_release(pool, grown[0]);
+    object_pool_destroy(pool);
+
+    printf("Snapshot iteration test passed.\n");
+    return 0;
+}
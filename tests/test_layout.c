@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define OBJECT_COUNT 256
+
+typedef struct
+{
+    double x, y, z;
+} Vector;
+
+// Acquires every object, checks its alignment and that objects do not overlap, then releases them
+static void check_layout(ObjectPool *pool, size_t alignment, size_t count)
+{
+    void *objects[OBJECT_COUNT * 2];
+    assert(count <= OBJECT_COUNT * 2);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        objects[i] = object_pool_acquire(pool);
+        assert(objects[i] != NULL);
+        assert((uintptr_t)objects[i] % alignment == 0);
+        Vector *v = objects[i];
+        v->x = v->y = v->z = (double)i;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector *v = objects[i];
+        assert(v->x == (double)i && v->z == (double)i);
+        object_pool_release(pool, objects[i]);
+    }
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_WARNING);
+
+    // Cache-line aligned objects each get a line of their own
+    ObjectPoolConfig config = {0};
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(Vector);
+    config.alignment = 64;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+    assert(pool->stride == 64);
+    check_layout(pool, 64, OBJECT_COUNT);
+
+    // Misaligned pointers into a padded slot are rejected
+    char *obj = object_pool_acquire(pool);
+    object_pool_release(pool, obj + sizeof(Vector));
+    object_pool_release(pool, obj);
+    object_pool_destroy(pool);
+
+    // Alignment must be a power of two within the supported range
+    config.alignment = 48;
+    assert(!object_pool_init_ex(&pool, &config));
+    config.alignment = OBJECT_POOL_MAX_ALIGNMENT * 2;
+    assert(!object_pool_init_ex(&pool, &config));
+
+    // mmap-backed chunks with huge pages, including chunks added by growth and resize
+    config.alignment = 32;
+    config.huge_pages = true;
+    config.growth = OBJECT_POOL_GROWTH_GEOMETRIC;
+    config.max_size = OBJECT_COUNT * 2;
+    assert(object_pool_init_ex(&pool, &config));
+    assert(pool->chunks[0].mapped_size > 0);
+    check_layout(pool, 32, OBJECT_COUNT * 2);
+    assert(pool->pool_size == OBJECT_COUNT * 2);
+    object_pool_destroy(pool);
+
+    // NUMA placement falls back to first touch when the kernel refuses the binding
+    config = (ObjectPoolConfig){0};
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(Vector);
+    config.numa_bind = true;
+    config.numa_node = 0;
+    assert(object_pool_init_ex(&pool, &config));
+    assert(object_pool_resize(pool, OBJECT_COUNT * 2));
+    check_layout(pool, sizeof(double), OBJECT_COUNT * 2);
+    object_pool_destroy(pool);
+
+    config.numa_node = -1;
+    assert(!object_pool_init_ex(&pool, &config));
+
+    log_info("Layout test passed.");
+    return 0;
+}
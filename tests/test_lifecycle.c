@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define OBJECT_COUNT 8
+#define BUFFER_SIZE 256
+
+// An object owning an expensive inner buffer that should survive reuse
+typedef struct
+{
+    char *buffer;
+    size_t length;
+} Message;
+
+typedef struct
+{
+    int constructed;
+    int destroyed;
+    int resets;
+    int fail_next;
+} HookCounts;
+
+static bool message_construct(void *object, void *user_data)
+{
+    HookCounts *counts = user_data;
+    if (counts->fail_next)
+    {
+        counts->fail_next = 0;
+        return false;
+    }
+
+    Message *message = object;
+    message->buffer = malloc(BUFFER_SIZE);
+    message->length = 0;
+    counts->constructed++;
+    return message->buffer != NULL;
+}
+
+static void message_destroy(void *object, void *user_data)
+{
+    HookCounts *counts = user_data;
+    free(((Message *)object)->buffer);
+    counts->destroyed++;
+}
+
+static void message_reset(void *object, void *user_data)
+{
+    HookCounts *counts = user_data;
+    ((Message *)object)->length = 0;
+    counts->resets++;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_ERROR);
+
+    HookCounts counts = {0};
+    ObjectPoolConfig config = {0};
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(Message);
+    config.constructor = message_construct;
+    config.destructor = message_destroy;
+    config.reset = message_reset;
+    config.hook_data = &counts;
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    config.max_size = OBJECT_COUNT * 2;
+
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+    assert(counts.constructed == 0);
+
+    // Construction happens lazily, once per slot; the buffer is kept across reuse
+    Message *message = object_pool_acquire(pool);
+    assert(message && message->buffer && counts.constructed == 1);
+    char *buffer = message->buffer;
+    message->length = snprintf(message->buffer, BUFFER_SIZE, "hello");
+    object_pool_release(pool, message);
+    assert(counts.resets == 1);
+
+    message = object_pool_acquire(pool);
+    assert(message->buffer == buffer && message->length == 0);
+    assert(counts.constructed == 1);
+
+    // An invalid release does not reset anything
+    object_pool_release(pool, message);
+    object_pool_release(pool, message);
+    assert(counts.resets == 2);
+
+    // A failing constructor fails the acquire and returns the slot
+    counts.fail_next = 1;
+    void *objects[OBJECT_COUNT * 2];
+    assert(object_pool_acquire_n(pool, objects, OBJECT_COUNT) == OBJECT_COUNT - 1);
+    assert(counts.constructed == OBJECT_COUNT - 1);
+    assert(object_pool_release_n(pool, objects, OBJECT_COUNT - 1) == OBJECT_COUNT - 1);
+    assert(counts.resets == 2 + OBJECT_COUNT - 1);
+
+    // Objects in a grown chunk are destroyed when shrinking frees it
+    assert(object_pool_acquire_n(pool, objects, OBJECT_COUNT * 2) == OBJECT_COUNT * 2);
+    assert(counts.constructed == OBJECT_COUNT * 2);
+    assert(object_pool_release_n(pool, objects, OBJECT_COUNT * 2) == OBJECT_COUNT * 2);
+    assert(object_pool_shrink(pool) == OBJECT_COUNT);
+    assert(counts.destroyed == OBJECT_COUNT);
+
+    // The revived chunk constructs its objects again
+    assert(object_pool_acquire_n(pool, objects, OBJECT_COUNT * 2) == OBJECT_COUNT * 2);
+    assert(counts.constructed == OBJECT_COUNT * 3);
+    assert(object_pool_release_n(pool, objects, OBJECT_COUNT * 2) == OBJECT_COUNT * 2);
+
+    // Destroy tears down everything still constructed
+    object_pool_destroy(pool);
+    assert(counts.destroyed == counts.constructed);
+
+    // Hooks work with thread caches and lock-free mode too
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        counts = (HookCounts){0};
+        config.growth = OBJECT_POOL_GROWTH_NONE;
+        config.max_size = 0;
+        config.mode = mode ? OBJECT_POOL_MODE_LOCK_FREE : OBJECT_POOL_MODE_MUTEX;
+        config.thread_cache_size = mode ? 0 : 4;
+        assert(object_pool_init_ex(&pool, &config));
+        for (int round = 0; round < 3; ++round)
+        {
+            assert(object_pool_acquire_n(pool, objects, OBJECT_COUNT) == OBJECT_COUNT);
+            assert(object_pool_release_n(pool, objects, OBJECT_COUNT) == OBJECT_COUNT);
+        }
+        assert(counts.constructed == OBJECT_COUNT);
+        assert(counts.resets == OBJECT_COUNT * 3);
+        object_pool_destroy(pool);
+        assert(counts.destroyed == OBJECT_COUNT);
+    }
+
+    log_info("Lifecycle test passed.");
+    return 0;
+}
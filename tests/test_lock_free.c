@@ -0,0 +1,116 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define THREAD_COUNT 8
+#define OBJECT_COUNT 16
+#define ITERATIONS 20000
+
+typedef struct
+{
+    ObjectPool *pool;
+    int thread_num;
+} ThreadArg;
+
+// Worker function: every held object must keep the value written by its owner
+void *lock_free_worker(void *arg)
+{
+    ThreadArg *thread_arg = (ThreadArg *)arg;
+    ObjectPool *pool = thread_arg->pool;
+
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        int *obj = (int *)object_pool_acquire(pool);
+        if (obj)
+        {
+            *obj = thread_arg->thread_num;
+            assert(*obj == thread_arg->thread_num);
+            object_pool_release(pool, obj);
+        }
+    }
+
+    return NULL;
+}
+
+// Callback function counting acquired objects
+void count_object(void *object, void *user_data)
+{
+    (void)object;
+    ++*(size_t *)user_data;
+}
+
+int main()
+{
+    ObjectPool *pool = NULL;
+    ObjectPoolConfig config = {0};
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(int);
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+
+    if (!object_pool_init_ex(&pool, &config))
+    {
+        log_error("Failed to initialize lock-free object pool.");
+        return 1;
+    }
+
+    pthread_t threads[THREAD_COUNT];
+    ThreadArg args[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; ++i)
+    {
+        args[i].pool = pool;
+        args[i].thread_num = i;
+        if (pthread_create(&threads[i], NULL, lock_free_worker, &args[i]) != 0)
+        {
+            log_error("Failed to create thread %d.", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < THREAD_COUNT; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    assert(pool->available == OBJECT_COUNT);
+
+    // Drain the pool and make sure every slot is handed out exactly once
+    void *objects[OBJECT_COUNT];
+    for (int i = 0; i < OBJECT_COUNT; ++i)
+    {
+        objects[i] = object_pool_acquire(pool);
+        assert(objects[i] != NULL);
+        for (int j = 0; j < i; ++j)
+        {
+            assert(objects[j] != objects[i]);
+        }
+    }
+    assert(object_pool_acquire(pool) == NULL);
+
+    size_t acquired = 0;
+    object_pool_iterate_acquired(pool, count_object, &acquired);
+    assert(acquired == OBJECT_COUNT);
+
+    // A double release must not push the slot twice
+    object_pool_release(pool, objects[0]);
+    object_pool_release(pool, objects[0]);
+    assert(pool->available == 1);
+
+    for (int i = 1; i < OBJECT_COUNT; ++i)
+    {
+        object_pool_release(pool, objects[i]);
+    }
+    assert(pool->available == OBJECT_COUNT);
+
+    // Growing adds a chunk without moving objects that are still held
+    int *held = (int *)object_pool_acquire(pool);
+    assert(held != NULL);
+    *held = 42;
+    assert(object_pool_resize(pool, OBJECT_COUNT * 2));
+    assert(pool->available == OBJECT_COUNT * 2 - 1);
+    assert(*held == 42);
+    object_pool_release(pool, held);
+
+    object_pool_destroy(pool);
+    printf("[INFO]: All lock-free tests passed successfully.\n");
+    return 0;
+}
@@ -0,0 +1,103 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define NUM_THREADS 4
+#define ITERATIONS 1000
+#define LONG_MESSAGE_SIZE 1000
+
+static int evaluations = 0;
+
+// Counts how often a logging argument is evaluated
+static int counted(int value)
+{
+    evaluations++;
+    return value;
+}
+
+// Logs a message longer than an async ring slot synchronously and returns the length written for it
+static size_t logged_length(const char *message)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    FILE *capture = tmpfile();
+    assert(saved >= 0 && capture != NULL);
+    dup2(fileno(capture), STDOUT_FILENO);
+    log_warning("%s", message);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    // The line is the prefix, the message and the color reset, so count the run of message characters
+    static char line[2 * LONG_MESSAGE_SIZE];
+    rewind(capture);
+    assert(fgets(line, sizeof(line), capture) != NULL);
+    fclose(capture);
+    char *start = strchr(line, message[0]);
+    assert(start != NULL);
+    return strspn(start, message);
+}
+
+// Hammers the pool while the asynchronous logger is active
+static void *worker(void *arg)
+{
+    ObjectPool *pool = arg;
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        void *obj = object_pool_acquire(pool);
+        if (obj)
+        {
+            object_pool_release(pool, obj);
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    // Below the runtime threshold the arguments are never evaluated
+    log_set_level(LOG_LEVEL_WARNING);
+    assert(log_get_level() == LOG_LEVEL_WARNING);
+    assert(!log_level_enabled(LOG_LEVEL_INFO));
+    assert(log_level_enabled(LOG_LEVEL_ERROR));
+    LOG_INFO("Filtered %d", counted(1));
+    assert(evaluations == 0);
+    LOG_WARNING("Emitted %d", counted(2));
+    assert(evaluations == (LOG_COMPILE_LEVEL <= 1 ? 1 : 0));
+
+    // Synchronous output is never truncated to the async slot size
+    static char long_message[LONG_MESSAGE_SIZE + 1];
+    memset(long_message, 'x', LONG_MESSAGE_SIZE);
+    assert(logged_length(long_message) == LONG_MESSAGE_SIZE);
+
+    // The pool logs every operation through the ring buffer; a small ring drops instead of blocking
+    log_set_level(LOG_LEVEL_INFO);
+    assert(log_async_start(64));
+    assert(log_async_start(64));
+
+    ObjectPool *pool = NULL;
+    assert(object_pool_init(&pool, NUM_THREADS, sizeof(int)));
+
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        assert(pthread_create(&threads[i], NULL, worker, pool) == 0);
+    }
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    object_pool_destroy(pool);
+    log_async_stop();
+
+    // Synchronous logging resumes once the writer thread is gone
+    log_info("Logger test passed.");
+    return 0;
+}
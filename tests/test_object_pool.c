@@ -94,6 +94,11 @@ int main()
         pthread_join(threads[i], NULL);
     }
 
+    // Hold an object across the resize to check that growth never moves it
+    int *held_obj = (int *)object_pool_acquire(pool);
+    assert(held_obj != NULL);
+    *held_obj = 123;
+
     // Test resizing
     if (!object_pool_resize(pool, OBJECT_COUNT * 2))
     {
@@ -103,6 +108,8 @@ int main()
     }
 
     log_info("Object pool resized successfully.");
+    assert(*held_obj == 123);
+    object_pool_release(pool, held_obj);
 
     // Test acquiring after resizing
     int *test_obj = (int *)object_pool_acquire(pool);
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "shm_pool.h"
+#include "cli_logger.h"
+
+#define POOL_SIZE 100
+#define KEPT_COUNT 10
+
+typedef struct
+{
+    int id;
+    char name[28];
+} Record;
+
+// Sums the ids of the records found after a restart and checks their contents
+static void check_record(void *object, void *user_data)
+{
+    Record *record = object;
+    char expected[sizeof(record->name)];
+    snprintf(expected, sizeof(expected), "record %d", record->id);
+    assert(strcmp(record->name, expected) == 0);
+    *(int *)user_data += record->id;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/object_pool_test_%d.pool", (int)getpid());
+    unlink(path);
+
+    // First run: fill some records, release every other one
+    ShmPool *pool = NULL;
+    assert(shm_pool_open_file(&pool, path, POOL_SIZE, sizeof(Record)));
+    assert(pool->persistent);
+    Record *records[2 * KEPT_COUNT];
+    for (int i = 0; i < 2 * KEPT_COUNT; i++)
+    {
+        records[i] = shm_pool_acquire(pool);
+        assert(records[i] != NULL);
+        records[i]->id = i;
+        snprintf(records[i]->name, sizeof(records[i]->name), "record %d", i);
+    }
+    for (int i = 1; i < 2 * KEPT_COUNT; i += 2)
+    {
+        shm_pool_release(pool, records[i]);
+    }
+    assert(shm_pool_sync(pool));
+
+    // The file is owned by one attachment at a time
+    ShmPool *second = NULL;
+    assert(!shm_pool_open_file(&second, path, POOL_SIZE, sizeof(Record)));
+    shm_pool_close(pool);
+
+    // A different geometry is rejected rather than reinterpreted
+    assert(!shm_pool_open_file(&pool, path, POOL_SIZE * 2, sizeof(Record)));
+    assert(!shm_pool_open_file(&pool, path, POOL_SIZE, sizeof(Record) * 2));
+
+    // Warm restart: the kept records are still acquired and intact
+    assert(shm_pool_open_file(&pool, path, POOL_SIZE, sizeof(Record)));
+    assert(shm_pool_available(pool) == POOL_SIZE - KEPT_COUNT);
+    int id_sum = 0;
+    assert(shm_pool_iterate_acquired(pool, check_record, &id_sum) == KEPT_COUNT);
+    assert(id_sum == 0 + 2 + 4 + 6 + 8 + 10 + 12 + 14 + 16 + 18);
+    shm_pool_close(pool);
+
+    // A child acquires more records and exits without closing the pool
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0)
+    {
+        ShmPool *crashed = NULL;
+        if (!shm_pool_open_file(&crashed, path, POOL_SIZE, sizeof(Record)))
+        {
+            _exit(1);
+        }
+        for (int i = 0; i < KEPT_COUNT; i++)
+        {
+            Record *record = shm_pool_acquire(crashed);
+            record->id = 100 + i;
+            snprintf(record->name, sizeof(record->name), "record %d", record->id);
+        }
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    // The lock died with the child, and the free list is rebuilt from the bitmap
+    assert(shm_pool_open_file(&pool, path, POOL_SIZE, sizeof(Record)));
+    assert(shm_pool_available(pool) == POOL_SIZE - 2 * KEPT_COUNT);
+    id_sum = 0;
+    assert(shm_pool_iterate_acquired(pool, check_record, &id_sum) == 2 * KEPT_COUNT);
+    assert(id_sum == 90 + 100 * KEPT_COUNT + 45);
+
+    // Every free object can still be acquired exactly once
+    size_t acquired = 0;
+    while (shm_pool_acquire(pool))
+    {
+        acquired++;
+    }
+    assert(acquired == POOL_SIZE - 2 * KEPT_COUNT);
+    shm_pool_close(pool);
+
+    unlink(path);
+    printf("Persistent pool test passed.\n");
+    return 0;
+}
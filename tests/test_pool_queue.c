@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include "pool_queue.h"
+#include "cli_logger.h"
+
+#define POOL_SIZE 64
+#define QUEUE_CAPACITY 16
+#define NUM_PRODUCERS 3
+#define NUM_CONSUMERS 3
+#define MESSAGES_PER_PRODUCER 20000
+
+typedef struct
+{
+    int producer;
+    int sequence;
+} Message;
+
+typedef struct
+{
+    ObjectPool *pool;
+    PoolQueue *queue;
+    int producer;
+    OBJECT_POOL_ATOMIC(int) consumed;
+    OBJECT_POOL_ATOMIC(long long) checksum;
+} Shared;
+
+typedef struct
+{
+    Shared *shared;
+    int producer;
+} ProducerArg;
+
+// Acquires, fills and enqueues messages, retrying while the pool or queue is full
+static void *producer(void *arg)
+{
+    ProducerArg *producer_arg = arg;
+    Shared *shared = producer_arg->shared;
+    for (int i = 0; i < MESSAGES_PER_PRODUCER; i++)
+    {
+        Message *message;
+        while ((message = object_pool_acquire(shared->pool)) == NULL)
+        {
+            sched_yield();
+        }
+        message->producer = producer_arg->producer;
+        message->sequence = i;
+
+        size_t index = object_pool_index_of(shared->pool, message);
+        while (!pool_queue_enqueue(shared->queue, index))
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Dequeues, checks and releases messages until every message has been consumed
+static void *consumer(void *arg)
+{
+    Shared *shared = arg;
+    int last_sequence[NUM_PRODUCERS];
+    memset(last_sequence, -1, sizeof(last_sequence));
+
+    while (atomic_load(&shared->consumed) < NUM_PRODUCERS * MESSAGES_PER_PRODUCER)
+    {
+        size_t index;
+        if (!pool_queue_dequeue(shared->queue, &index))
+        {
+            sched_yield();
+            continue;
+        }
+
+        // Messages from one producer arrive in the order they were sent
+        Message *message = object_pool_at(shared->pool, index);
+        assert(message->producer >= 0 && message->producer < NUM_PRODUCERS);
+        assert(message->sequence > last_sequence[message->producer]);
+        last_sequence[message->producer] = message->sequence;
+        atomic_fetch_add(&shared->checksum, message->sequence);
+        object_pool_release(shared->pool, message);
+        atomic_fetch_add(&shared->consumed, 1);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    ObjectPoolConfig config = {0};
+    config.initial_size = POOL_SIZE;
+    config.object_size = sizeof(Message);
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+
+    // Slot indices and pointers convert both ways; foreign pointers have no index
+    void *object = object_pool_acquire(pool);
+    size_t index = object_pool_index_of(pool, object);
+    assert(index < POOL_SIZE);
+    assert(object_pool_at(pool, index) == object);
+    assert(object_pool_at(pool, POOL_SIZE) == NULL);
+    Message foreign;
+    assert(object_pool_index_of(pool, &foreign) == OBJECT_POOL_INVALID_INDEX);
+    object_pool_release(pool, object);
+
+    // Capacity is rounded up to a power of two and the queue is first in, first out
+    PoolQueue *queue = NULL;
+    assert(pool_queue_init(&queue, pool, 5));
+    assert(queue->capacity == 8);
+    void *objects[8];
+    for (int i = 0; i < 8; i++)
+    {
+        objects[i] = object_pool_acquire(pool);
+        assert(pool_queue_push(queue, objects[i]));
+    }
+    assert(!pool_queue_push(queue, objects[0]));
+    assert(!pool_queue_push(queue, &foreign));
+    assert(pool_queue_size(queue) == 8);
+    for (int i = 0; i < 4; i++)
+    {
+        assert(pool_queue_pop(queue) == objects[i]);
+        object_pool_release(pool, objects[i]);
+    }
+
+    // Destroying the queue releases the objects still in it
+    assert(pool->available == POOL_SIZE - 4);
+    pool_queue_destroy(queue);
+    assert(pool->available == POOL_SIZE);
+
+    // Producers and consumers pass every message exactly once
+    Shared shared = {.pool = pool};
+    assert(pool_queue_init(&shared.queue, pool, QUEUE_CAPACITY));
+    assert(pool_queue_pop(shared.queue) == NULL);
+    atomic_init(&shared.consumed, 0);
+    atomic_init(&shared.checksum, 0);
+
+    pthread_t producers[NUM_PRODUCERS];
+    pthread_t consumers[NUM_CONSUMERS];
+    ProducerArg args[NUM_PRODUCERS];
+    for (int i = 0; i < NUM_PRODUCERS; i++)
+    {
+        args[i].shared = &shared;
+        args[i].producer = i;
+        assert(pthread_create(&producers[i], NULL, producer, &args[i]) == 0);
+    }
+    for (int i = 0; i < NUM_CONSUMERS; i++)
+    {
+        assert(pthread_create(&consumers[i], NULL, consumer, &shared) == 0);
+    }
+    for (int i = 0; i < NUM_PRODUCERS; i++)
+    {
+        pthread_join(producers[i], NULL);
+    }
+    for (int i = 0; i < NUM_CONSUMERS; i++)
+    {
+        pthread_join(consumers[i], NULL);
+    }
+
+    long long expected = (long long)NUM_PRODUCERS * MESSAGES_PER_PRODUCER * (MESSAGES_PER_PRODUCER - 1) / 2;
+    assert(atomic_load(&shared.checksum) == expected);
+    assert(pool_queue_size(shared.queue) == 0);
+    assert(pool->available == POOL_SIZE);
+    pool_queue_destroy(shared.queue);
+
+    object_pool_destroy(pool);
+
+    printf("Pool queue test passed.\n");
+    return 0;
+}
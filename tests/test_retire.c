@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define POOL_SIZE 16
+#define NUM_READERS 4
+#define UPDATES 20000
+
+// A published value whose two halves must always agree while readers can see it
+typedef struct
+{
+    uint64_t value;
+    uint64_t check;
+} Record;
+
+typedef struct
+{
+    ObjectPool *pool;
+    _Atomic(Record *) current;
+    atomic_bool stop;
+    atomic_bool entered;
+    atomic_bool leave;
+    atomic_size_t reads;
+} Shared;
+
+// Poisons released records so a premature reuse is visible to readers
+static void poison(void *object, void *user_data)
+{
+    (void)user_data;
+    Record *record = object;
+    record->value = 0xdeaddeaddeaddeadull;
+    record->check = 0;
+}
+
+// Counts objects that actually went back to the pool
+static void count_reset(void *object, void *user_data)
+{
+    (void)object;
+    (*(int *)user_data)++;
+}
+
+// Destroys a pool with warnings enabled and reports whether it logged anything
+static bool destroy_logs_problems(ObjectPool *pool)
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    FILE *capture = tmpfile();
+    assert(saved >= 0 && capture != NULL);
+    dup2(fileno(capture), STDOUT_FILENO);
+    log_set_level(LOG_LEVEL_WARNING);
+    object_pool_destroy(pool);
+    fflush(stdout);
+    log_set_level(LOG_LEVEL_NONE);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    struct stat info;
+    assert(fstat(fileno(capture), &info) == 0);
+    fclose(capture);
+    return info.st_size > 0;
+}
+
+// Holds a read section open until told to leave
+static void *blocking_reader(void *arg)
+{
+    Shared *shared = arg;
+    assert(object_pool_read_lock(shared->pool));
+    atomic_store(&shared->entered, true);
+    while (!atomic_load(&shared->leave))
+    {
+        sched_yield();
+    }
+    object_pool_read_unlock(shared->pool);
+    return NULL;
+}
+
+// Reads the current record inside read sections and checks it was never recycled underneath
+static void *reader(void *arg)
+{
+    Shared *shared = arg;
+    while (!atomic_load(&shared->stop))
+    {
+        assert(object_pool_read_lock(shared->pool));
+        Record *record = atomic_load(&shared->current);
+        uint64_t value = record->value;
+        sched_yield();
+        assert(record->check == ~value && record->value == value);
+        object_pool_read_unlock(shared->pool);
+        atomic_fetch_add(&shared->reads, 1);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    ObjectPoolConfig config = {0};
+    config.initial_size = POOL_SIZE;
+    config.object_size = sizeof(Record);
+    config.reset = poison;
+
+    Shared shared = {0};
+    assert(object_pool_init_ex(&shared.pool, &config));
+    ObjectPool *pool = shared.pool;
+
+    // An active reader holds back reclamation of objects retired during its section
+    Record *first = object_pool_acquire(pool);
+    assert(first != NULL);
+    pthread_t blocker;
+    assert(pthread_create(&blocker, NULL, blocking_reader, &shared) == 0);
+    while (!atomic_load(&shared.entered))
+    {
+        sched_yield();
+    }
+    assert(object_pool_retire(pool, first));
+    for (int i = 0; i < 4; i++)
+    {
+        assert(object_pool_reclaim(pool) == 0);
+    }
+    assert(pool->available == POOL_SIZE - 1);
+    atomic_store(&shared.leave, true);
+    pthread_join(blocker, NULL);
+    object_pool_synchronize(pool);
+    assert(pool->available == POOL_SIZE);
+
+    // Read sections nest, and a thread's own section does not block other retirements once left
+    assert(object_pool_read_lock(pool));
+    assert(object_pool_read_lock(pool));
+    object_pool_read_unlock(pool);
+    object_pool_read_unlock(pool);
+    Record *second = object_pool_acquire(pool);
+    assert(object_pool_retire(pool, second));
+    object_pool_synchronize(pool);
+    assert(pool->available == POOL_SIZE);
+
+    // Concurrent readers never observe a record that was released and poisoned
+    Record *initial = object_pool_acquire(pool);
+    initial->value = 0;
+    initial->check = ~0ull;
+    atomic_store(&shared.current, initial);
+
+    pthread_t readers[NUM_READERS];
+    for (int i = 0; i < NUM_READERS; i++)
+    {
+        assert(pthread_create(&readers[i], NULL, reader, &shared) == 0);
+    }
+
+    for (uint64_t update = 1; update <= UPDATES; update++)
+    {
+        Record *next;
+        while ((next = object_pool_acquire(pool)) == NULL)
+        {
+            object_pool_reclaim(pool);
+            sched_yield();
+        }
+        next->value = update;
+        next->check = ~update;
+        Record *old = atomic_exchange(&shared.current, next);
+        assert(object_pool_retire(pool, old));
+    }
+
+    atomic_store(&shared.stop, true);
+    for (int i = 0; i < NUM_READERS; i++)
+    {
+        pthread_join(readers[i], NULL);
+    }
+    assert(atomic_load(&shared.reads) > 0);
+
+    object_pool_synchronize(pool);
+    assert(pool->available == POOL_SIZE - 1);
+    object_pool_release(pool, atomic_load(&shared.current));
+
+    // Objects still waiting for a grace period are released by destroy
+    Record *pending = object_pool_acquire(pool);
+    assert(object_pool_retire(pool, pending));
+    object_pool_destroy(pool);
+
+    // Destroy drains retired objects through the thread cache before tearing the caches down
+    int resets = 0;
+    config = (ObjectPoolConfig){0};
+    config.initial_size = POOL_SIZE;
+    config.object_size = sizeof(Record);
+    config.thread_cache_size = 4;
+    config.reset = count_reset;
+    config.hook_data = &resets;
+    assert(object_pool_init_ex(&pool, &config));
+    Record *cached = object_pool_acquire(pool);
+    object_pool_release(pool, cached);
+    assert(resets == 1);
+    assert(object_pool_read_lock(pool));
+    for (int i = 0; i < POOL_SIZE; i++)
+    {
+        Record *record = object_pool_acquire(pool);
+        assert(record != NULL);
+        assert(object_pool_retire(pool, record));
+    }
+    object_pool_read_unlock(pool);
+    assert(resets == 1);
+    assert(!destroy_logs_problems(pool));
+    assert(resets == 1 + POOL_SIZE);
+
+    printf("Retire test passed.\n");
+    return 0;
+}
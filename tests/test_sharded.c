@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include "sharded_pool.h"
+#include "cli_logger.h"
+
+#define SHARD_COUNT 4
+#define TOTAL_SIZE 66
+#define NUM_THREADS 8
+#define ITERATIONS 5000
+#define HELD_PER_THREAD 4
+
+typedef struct
+{
+    pthread_t owner;
+    int sequence;
+} Item;
+
+// Acquires and releases a few objects at a time, checking nobody else touches them
+static void *worker(void *arg)
+{
+    ShardedPool *pool = arg;
+    pthread_t self = pthread_self();
+
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        Item *held[HELD_PER_THREAD];
+        for (int j = 0; j < HELD_PER_THREAD; j++)
+        {
+            // A steal can race with objects moving between shards, so retry a miss
+            while ((held[j] = sharded_pool_acquire(pool)) == NULL)
+            {
+                sched_yield();
+            }
+            held[j]->owner = self;
+            held[j]->sequence = i;
+        }
+        for (int j = 0; j < HELD_PER_THREAD; j++)
+        {
+            assert(pthread_equal(held[j]->owner, self) && held[j]->sequence == i);
+            sharded_pool_release(pool, held[j]);
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    ShardedPoolConfig config = {0};
+    config.total_size = TOTAL_SIZE;
+    config.object_size = sizeof(Item);
+    config.shard_count = SHARD_COUNT;
+    config.steal_batch = 4;
+
+    ShardedPool *pool = NULL;
+    assert(sharded_pool_init(&pool, &config));
+    assert(pool->shard_count == SHARD_COUNT);
+
+    // The remainder is spread over the first shards
+    size_t total = 0;
+    for (size_t i = 0; i < SHARD_COUNT; i++)
+    {
+        size_t size = sharded_pool_shard(pool, i)->pool_size;
+        assert(size == TOTAL_SIZE / SHARD_COUNT + (i < TOTAL_SIZE % SHARD_COUNT ? 1 : 0));
+        total += size;
+    }
+    assert(total == TOTAL_SIZE);
+    assert(sharded_pool_shard(pool, SHARD_COUNT) == NULL);
+
+    // One thread drains every shard by stealing, and never gets the same object twice
+    void *objects[TOTAL_SIZE];
+    for (size_t i = 0; i < TOTAL_SIZE; i++)
+    {
+        objects[i] = sharded_pool_acquire(pool);
+        assert(objects[i] != NULL);
+        for (size_t j = 0; j < i; j++)
+        {
+            assert(objects[j] != objects[i]);
+        }
+    }
+    assert(sharded_pool_acquire(pool) == NULL);
+    assert(sharded_pool_available(pool) == 0);
+    assert(pool->steals > 0);
+
+    // Releases return objects to their owning shards
+    for (size_t i = 0; i < TOTAL_SIZE; i++)
+    {
+        sharded_pool_release(pool, objects[i]);
+    }
+    assert(sharded_pool_available(pool) == TOTAL_SIZE);
+    for (size_t i = 0; i < SHARD_COUNT; i++)
+    {
+        ObjectPool *shard = sharded_pool_shard(pool, i);
+        assert(shard->available == shard->pool_size);
+    }
+
+    // Foreign pointers are rejected
+    Item foreign;
+    sharded_pool_release(pool, &foreign);
+    assert(sharded_pool_available(pool) == TOTAL_SIZE);
+
+    // Concurrent use from more threads than shards keeps the total intact
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, worker, pool) == 0);
+    }
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    assert(sharded_pool_available(pool) == TOTAL_SIZE);
+    sharded_pool_destroy(pool);
+
+    // The default shard count follows the CPU count, capped by the pool size
+    config.shard_count = 0;
+    config.steal_batch = 0;
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    assert(sharded_pool_init(&pool, &config));
+    assert(pool->shard_count >= 1 && pool->shard_count <= TOTAL_SIZE);
+    assert(sharded_pool_current_shard(pool) < pool->shard_count);
+    void *object = sharded_pool_acquire(pool);
+    assert(object != NULL);
+    sharded_pool_release(pool, object);
+    sharded_pool_destroy(pool);
+
+    printf("Sharded pool test passed.\n");
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "shm_pool.h"
+#include "cli_logger.h"
+
+#define POOL_SIZE 64
+#define HANDOFF_COUNT 16
+
+typedef struct
+{
+    int producer;
+    int sequence;
+    char payload[40];
+} Message;
+
+// Child process: attaches by name, fills objects and hands their offsets to the parent
+static int run_producer(const char *name, int write_fd)
+{
+    ShmPool *pool = NULL;
+    if (!shm_pool_open(&pool, name))
+    {
+        return 1;
+    }
+
+    for (int i = 0; i < HANDOFF_COUNT; i++)
+    {
+        Message *message = shm_pool_acquire(pool);
+        if (!message)
+        {
+            return 1;
+        }
+        message->producer = (int)getpid();
+        message->sequence = i;
+        snprintf(message->payload, sizeof(message->payload), "message %d", i);
+
+        uint64_t offset = shm_pool_offset(pool, message);
+        if (write(write_fd, &offset, sizeof(offset)) != sizeof(offset))
+        {
+            return 1;
+        }
+    }
+
+    shm_pool_close(pool);
+    return 0;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    char name[64];
+    snprintf(name, sizeof(name), "/object_pool_test_%d", (int)getpid());
+
+    ShmPool *pool = NULL;
+    assert(shm_pool_create(&pool, name, POOL_SIZE, sizeof(Message)));
+    assert(shm_pool_available(pool) == POOL_SIZE);
+
+    // The name is taken until unlinked
+    ShmPool *duplicate = NULL;
+    assert(!shm_pool_create(&duplicate, name, POOL_SIZE, sizeof(Message)));
+
+    // A child process fills objects and passes offsets; the parent reads them zero-copy
+    int pipe_fds[2];
+    assert(pipe(pipe_fds) == 0);
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0)
+    {
+        close(pipe_fds[0]);
+        _exit(run_producer(name, pipe_fds[1]));
+    }
+    close(pipe_fds[1]);
+
+    for (int i = 0; i < HANDOFF_COUNT; i++)
+    {
+        uint64_t offset;
+        assert(read(pipe_fds[0], &offset, sizeof(offset)) == sizeof(offset));
+        Message *message = shm_pool_pointer(pool, offset);
+        assert(message != NULL);
+        assert(message->producer == (int)child && message->sequence == i);
+        char expected[40];
+        snprintf(expected, sizeof(expected), "message %d", i);
+        assert(strcmp(message->payload, expected) == 0);
+
+        // Objects acquired by one process may be released by another
+        shm_pool_release(pool, message);
+    }
+    close(pipe_fds[0]);
+
+    int status;
+    assert(waitpid(child, &status, 0) == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(shm_pool_available(pool) == POOL_SIZE);
+
+    // Invalid pointers and offsets are rejected
+    Message local;
+    shm_pool_release(pool, &local);
+    assert(shm_pool_available(pool) == POOL_SIZE);
+    assert(shm_pool_offset(pool, &local) == SHM_POOL_NULL_OFFSET);
+    assert(shm_pool_pointer(pool, 1) == NULL);
+
+    shm_pool_close(pool);
+    assert(shm_pool_unlink(name));
+    assert(!shm_pool_open(&pool, name));
+
+    // Two mappings of one memfd sit at different addresses but share objects through offsets
+    ShmPool *first = NULL;
+    ShmPool *second = NULL;
+    assert(shm_pool_create(&first, NULL, POOL_SIZE, sizeof(Message)));
+    assert(shm_pool_open_fd(&second, shm_pool_fd(first)));
+    assert((void *)first->header != (void *)second->header);
+
+    Message *objects[POOL_SIZE];
+    for (int i = 0; i < POOL_SIZE; i++)
+    {
+        objects[i] = shm_pool_acquire(first);
+        assert(objects[i] != NULL);
+        objects[i]->sequence = i;
+    }
+    assert(shm_pool_acquire(second) == NULL);
+
+    for (int i = 0; i < POOL_SIZE; i++)
+    {
+        Message *view = shm_pool_pointer(second, shm_pool_offset(first, objects[i]));
+        assert(view != NULL && view != objects[i] && view->sequence == i);
+        shm_pool_release(second, view);
+    }
+    assert(shm_pool_available(first) == POOL_SIZE);
+
+    // A double release through either mapping is caught by the shared bitmap
+    Message *again = shm_pool_acquire(first);
+    shm_pool_release(first, again);
+    shm_pool_release(second, shm_pool_pointer(second, shm_pool_offset(first, again)));
+    assert(shm_pool_available(first) == POOL_SIZE);
+
+    shm_pool_close(second);
+    shm_pool_close(first);
+
+    printf("Shared memory pool test passed.\n");
+    return 0;
+}
@@ -22,8 +22,8 @@ int main()
     log_info("Acquired and set value to %.2f.", *val);
 
     // Release the object
+    log_info("Releasing object with value %.2f.", *val);
     object_pool_release(pool, val);
-    log_info("Released object with value %.2f.", *val);
 
     // Attempt to acquire the same object again
     double *val2 = (double *)object_pool_acquire(pool);
@@ -33,8 +33,8 @@ int main()
     log_info("Re-acquired and set value to %.2f.", *val2);
 
     // Release the object again
+    log_info("Releasing object with value %.2f.", *val2);
     object_pool_release(pool, val2);
-    log_info("Released object with value %.2f.", *val2);
 
     // Destroy the pool
     object_pool_destroy(pool);
@@ -0,0 +1,137 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "size_class_pool.h"
+#include "cli_logger.h"
+
+#define NUM_THREADS 4
+#define ITERATIONS 2000
+#define LIVE_SLOTS 32
+
+// Allocates, fills, checks and frees blocks of varying sizes
+static void *worker(void *arg)
+{
+    SizeClassPool *pool = arg;
+    void *live[LIVE_SLOTS] = {0};
+    size_t sizes[LIVE_SLOTS] = {0};
+    unsigned seed = (unsigned)(uintptr_t)pthread_self();
+
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        int slot = rand_r(&seed) % LIVE_SLOTS;
+        if (live[slot])
+        {
+            unsigned char *bytes = live[slot];
+            assert(bytes[0] == (unsigned char)slot && bytes[sizes[slot] - 1] == (unsigned char)slot);
+            size_class_pool_free(pool, live[slot]);
+        }
+        sizes[slot] = 1 + (size_t)(rand_r(&seed) % 6000);
+        live[slot] = size_class_pool_alloc(pool, sizes[slot]);
+        assert(live[slot] != NULL);
+        memset(live[slot], slot, sizes[slot]);
+    }
+
+    for (int slot = 0; slot < LIVE_SLOTS; ++slot)
+    {
+        size_class_pool_free(pool, live[slot]);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_ERROR);
+
+    // Every size maps to the smallest class that fits it
+    for (size_t size = 1; size <= SIZE_CLASS_POOL_MAX_CLASS_SIZE; size += size < 4096 ? 1 : 97)
+    {
+        size_t index = size_class_index(size);
+        assert(index < SIZE_CLASS_POOL_MAX_CLASSES);
+        assert(size_class_size(index) >= size);
+        assert(index == 0 || size_class_size(index - 1) < size);
+    }
+    assert(size_class_size(0) == 16 && size_class_size(7) == 128 && size_class_size(8) == 160);
+    assert(size_class_size(11) == 256 && size_class_size(12) == 320);
+    assert(size_class_size(SIZE_CLASS_POOL_MAX_CLASSES - 1) == SIZE_CLASS_POOL_MAX_CLASS_SIZE);
+
+    SizeClassPool *pool = NULL;
+    assert(size_class_pool_init(&pool, NULL));
+
+    // Allocations are aligned, sized by class and freed without a size
+    void *small = size_class_pool_alloc(pool, 20);
+    void *medium = size_class_pool_alloc(pool, 200);
+    void *large = size_class_pool_alloc(pool, 100000);
+    assert(small && medium && large);
+    assert((uintptr_t)small % 16 == 0 && (uintptr_t)medium % 16 == 0 && (uintptr_t)large % 16 == 0);
+    assert(size_class_pool_usable_size(pool, small) == 32);
+    assert(size_class_pool_usable_size(pool, medium) == 224);
+    assert(size_class_pool_usable_size(pool, large) == 100000);
+    memset(small, 1, 32);
+    memset(medium, 2, 224);
+    memset(large, 3, 100000);
+
+    size_class_pool_free(pool, small);
+    size_class_pool_free(pool, medium);
+    size_class_pool_free(pool, large);
+    size_class_pool_free(pool, NULL);
+
+    // A freed block is reused by the next request in its class; a double free is rejected
+    void *again = size_class_pool_alloc(pool, 17);
+    assert(again == small);
+    size_class_pool_free(pool, again);
+    size_class_pool_free(pool, again);
+    assert(size_class_pool_usable_size(pool, again) == 0);
+
+    // Unknown pointers are rejected from the page map alone, without reading memory around them
+    int local = 0;
+    size_class_pool_free(pool, &local);
+    assert(size_class_pool_usable_size(pool, &local) == 0);
+    void *big = size_class_pool_alloc(pool, 10000);
+    assert(size_class_pool_usable_size(pool, (char *)big + 16) == 0);
+    size_class_pool_free(pool, (char *)big + 16);
+    assert(size_class_pool_usable_size(pool, big) == 10000);
+    size_class_pool_free(pool, big);
+    size_class_pool_free(pool, big);
+    assert(size_class_pool_usable_size(pool, big) == 0);
+
+    // Pooled blocks carry no header, so a class pool's objects are exactly the class size
+    ObjectPool *class = pool->classes[size_class_index(20)];
+    assert(class->object_size == 32);
+
+    // Concurrent mixed-size traffic grows the class pools as needed
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        assert(pthread_create(&threads[i], NULL, worker, pool) == 0);
+    }
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    size_class_pool_destroy(pool);
+
+    // Thread-cached, lock-free class pools with a smaller class limit
+    SizeClassPoolConfig config = {0};
+    config.max_class_size = 1000;
+    config.thread_cache_size = 8;
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    assert(size_class_pool_init(&pool, &config));
+    assert(pool->max_class_size == 1024);
+    void *block = size_class_pool_alloc(pool, 1024);
+    void *beyond = size_class_pool_alloc(pool, 1025);
+    assert(size_class_pool_usable_size(pool, block) == 1024);
+    assert(size_class_pool_usable_size(pool, beyond) == 1025);
+    size_class_pool_free(pool, block);
+    size_class_pool_free(pool, beyond);
+    size_class_pool_destroy(pool);
+
+    config.max_class_size = SIZE_CLASS_POOL_MAX_CLASS_SIZE * 2;
+    assert(!size_class_pool_init(&pool, &config));
+
+    log_info("Size class test passed.");
+    return 0;
+}
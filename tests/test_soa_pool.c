@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include "soa_pool.h"
+#include "cli_logger.h"
+
+#define CAPACITY 200
+#define NUM_THREADS 4
+#define ITERATIONS 20000
+
+enum
+{
+    PRICE,
+    QUANTITY,
+    NAME,
+    FIELD_COUNT
+};
+
+typedef struct
+{
+    size_t runs;
+    size_t firsts[8];
+    size_t counts[8];
+    double total;
+} ScanResult;
+
+// Records each run and sums price * quantity over it
+static void scan_run(SoaPool *pool, size_t first, size_t count, void *user_data)
+{
+    ScanResult *result = user_data;
+    const double *price = soa_pool_column(pool, PRICE);
+    const int32_t *quantity = soa_pool_column(pool, QUANTITY);
+    if (result->runs < 8)
+    {
+        result->firsts[result->runs] = first;
+        result->counts[result->runs] = count;
+    }
+    result->runs++;
+    for (size_t i = first; i < first + count; i++)
+    {
+        result->total += price[i] * quantity[i];
+    }
+}
+
+// Acquires and releases records, checking nobody else writes to them meanwhile
+static void *worker(void *arg)
+{
+    SoaPool *pool = arg;
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        size_t index = soa_pool_acquire(pool);
+        if (index == OBJECT_POOL_INVALID_INDEX)
+        {
+            continue;
+        }
+        int32_t *quantity = soa_pool_field(pool, index, QUANTITY);
+        *quantity = i;
+        assert(*quantity == i);
+        soa_pool_release(pool, index);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_NONE);
+
+    const size_t schema[FIELD_COUNT] = {sizeof(double), sizeof(int32_t), 13};
+    SoaPool *pool = NULL;
+    assert(!soa_pool_init(&pool, 0, schema, FIELD_COUNT));
+    assert(!soa_pool_init(&pool, CAPACITY, schema, 0));
+    const size_t bad_schema[2] = {8, 0};
+    assert(!soa_pool_init(&pool, CAPACITY, bad_schema, 2));
+    assert(soa_pool_init(&pool, CAPACITY, schema, FIELD_COUNT));
+
+    // Every column is aligned and holds its field at index * size
+    for (size_t f = 0; f < FIELD_COUNT; f++)
+    {
+        char *column = soa_pool_column(pool, f);
+        assert(((uintptr_t)column % SOA_POOL_COLUMN_ALIGNMENT) == 0);
+        assert((char *)soa_pool_field(pool, 7, f) == column + 7 * schema[f]);
+    }
+    assert(soa_pool_column(pool, FIELD_COUNT) == NULL);
+    assert(soa_pool_field(pool, CAPACITY, PRICE) == NULL);
+
+    // Acquire every record, then the pool is empty
+    for (size_t i = 0; i < CAPACITY; i++)
+    {
+        size_t index = soa_pool_acquire(pool);
+        assert(index == i);
+        *(double *)soa_pool_field(pool, index, PRICE) = 0.5;
+        *(int32_t *)soa_pool_field(pool, index, QUANTITY) = (int32_t)i;
+    }
+    assert(soa_pool_acquire(pool) == OBJECT_POOL_INVALID_INDEX);
+    assert(soa_pool_available(pool) == 0);
+
+    // A full pool is one run spanning all bitmap words
+    ScanResult result = {0};
+    assert(soa_pool_iterate(pool, scan_run, &result) == CAPACITY);
+    assert(result.runs == 1 && result.firsts[0] == 0 && result.counts[0] == CAPACITY);
+    assert(result.total == 0.5 * CAPACITY * (CAPACITY - 1) / 2);
+
+    // Holes split the live slots into maximal runs, including across word boundaries
+    soa_pool_release(pool, 3);
+    soa_pool_release(pool, 4);
+    soa_pool_release(pool, 64);
+    soa_pool_release(pool, CAPACITY - 1);
+    soa_pool_release(pool, CAPACITY - 1);
+    soa_pool_release(pool, CAPACITY);
+    assert(soa_pool_available(pool) == 4);
+    result = (ScanResult){0};
+    assert(soa_pool_iterate(pool, scan_run, &result) == CAPACITY - 4);
+    assert(result.runs == 3);
+    assert(result.firsts[0] == 0 && result.counts[0] == 3);
+    assert(result.firsts[1] == 5 && result.counts[1] == 59);
+    assert(result.firsts[2] == 65 && result.counts[2] == CAPACITY - 66);
+
+    // Released slots come back most recently released first
+    assert(soa_pool_acquire(pool) == CAPACITY - 1);
+    assert(soa_pool_acquire(pool) == 64);
+    for (size_t i = 0; i < CAPACITY; i++)
+    {
+        if (i != 3 && i != 4)
+        {
+            soa_pool_release(pool, i);
+        }
+    }
+    assert(soa_pool_available(pool) == CAPACITY);
+    result = (ScanResult){0};
+    assert(soa_pool_iterate(pool, scan_run, &result) == 0);
+    assert(result.runs == 0);
+
+    // Concurrent acquire and release keep the free stack consistent
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, worker, pool) == 0);
+    }
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    assert(soa_pool_available(pool) == CAPACITY);
+    for (size_t i = 0; i < CAPACITY; i++)
+    {
+        assert(soa_pool_acquire(pool) != OBJECT_POOL_INVALID_INDEX);
+    }
+    assert(soa_pool_acquire(pool) == OBJECT_POOL_INVALID_INDEX);
+
+    soa_pool_destroy(pool);
+
+    printf("SoA pool test passed.\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define OBJECT_COUNT 16
+#define NUM_THREADS 4
+#define ITERATIONS 5000
+
+// Returns the number of sampled acquires in the latency histogram
+static uint64_t latency_samples(const ObjectPoolStats *stats)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < OBJECT_POOL_LATENCY_BUCKETS; ++i)
+    {
+        total += stats->acquire_latency[i];
+    }
+    return total;
+}
+
+// Acquires and releases in a loop so the threads contend for the pool
+static void *worker(void *arg)
+{
+    ObjectPool *pool = arg;
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        void *obj = object_pool_acquire(pool);
+        if (obj)
+        {
+            object_pool_release(pool, obj);
+        }
+    }
+    return NULL;
+}
+
+// Checks the counters of a pool hammered by several threads
+static void run_threaded(ObjectPoolConfig config)
+{
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        assert(pthread_create(&threads[i], NULL, worker, pool) == 0);
+    }
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    ObjectPoolStats stats;
+    assert(object_pool_get_stats(pool, &stats));
+    assert(stats.acquires + stats.failed_acquires == NUM_THREADS * ITERATIONS);
+    assert(stats.releases == stats.acquires);
+    assert(stats.in_use == 0);
+    assert(stats.high_water_mark <= OBJECT_COUNT);
+    assert(latency_samples(&stats) >= NUM_THREADS * ITERATIONS / OBJECT_POOL_LATENCY_SAMPLE_INTERVAL);
+    assert(stats.lock_contentions > 0 || stats.lock_wait_ns == 0);
+    object_pool_destroy(pool);
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_ERROR);
+
+    ObjectPoolConfig config = {0};
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(int);
+    config.growth = OBJECT_POOL_GROWTH_LINEAR;
+    config.growth_step = OBJECT_COUNT;
+    config.max_size = OBJECT_COUNT * 2;
+    ObjectPool *pool = NULL;
+    assert(object_pool_init_ex(&pool, &config));
+
+    // Acquire past the initial size to trigger growth, then past max_size to fail
+    void *objects[OBJECT_COUNT * 2 + 1];
+    for (int i = 0; i < OBJECT_COUNT * 2 + 1; ++i)
+    {
+        objects[i] = object_pool_acquire(pool);
+    }
+    assert(objects[OBJECT_COUNT * 2] == NULL);
+
+    ObjectPoolStats stats;
+    assert(object_pool_get_stats(pool, &stats));
+    assert(stats.acquires == OBJECT_COUNT * 2);
+    assert(stats.failed_acquires == 1);
+    assert(stats.in_use == OBJECT_COUNT * 2);
+    assert(stats.high_water_mark == OBJECT_COUNT * 2);
+    assert(stats.pool_size == OBJECT_COUNT * 2);
+    assert(stats.available == 0);
+    assert(stats.resizes == 1);
+    assert(latency_samples(&stats) == (OBJECT_COUNT * 2 + OBJECT_POOL_LATENCY_SAMPLE_INTERVAL) / OBJECT_POOL_LATENCY_SAMPLE_INTERVAL);
+
+    // Batched releases and invalid releases: only real releases are counted
+    assert(object_pool_release_n(pool, objects, OBJECT_COUNT * 2) == OBJECT_COUNT * 2);
+    object_pool_release(pool, objects[0]);
+    assert(object_pool_get_stats(pool, &stats));
+    assert(stats.releases == OBJECT_COUNT * 2);
+    assert(stats.in_use == 0);
+    assert(stats.high_water_mark == OBJECT_COUNT * 2);
+
+    // Explicit resizes and shrinks are counted too
+    assert(object_pool_shrink(pool) == OBJECT_COUNT);
+    assert(object_pool_resize(pool, OBJECT_COUNT * 3));
+    assert(object_pool_get_stats(pool, &stats));
+    assert(stats.shrinks == 1);
+    assert(stats.resizes == 2);
+    assert(!object_pool_get_stats(pool, NULL));
+    object_pool_destroy(pool);
+
+    // Counters add up across threads in every mode
+    config = (ObjectPoolConfig){0};
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(int);
+    run_threaded(config);
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    run_threaded(config);
+    config.mode = OBJECT_POOL_MODE_MUTEX;
+    config.thread_cache_size = 2;
+    run_threaded(config);
+
+    log_info("Stats test passed.");
+    return 0;
+}
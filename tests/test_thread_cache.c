@@ -0,0 +1,112 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <assert.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+// Each thread holds at most 4 objects plus CACHE_SIZE cached ones, so the
+// pool is sized to never run dry while other threads hoard free slots.
+#define THREAD_COUNT 8
+#define OBJECT_COUNT 128
+#define CACHE_SIZE 8
+#define ITERATIONS 10000
+
+// Worker function: acquire a handful of objects, write to them, release them
+void *cache_worker(void *arg)
+{
+    ObjectPool *pool = (ObjectPool *)arg;
+    int *held[4];
+
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            held[j] = (int *)object_pool_acquire(pool);
+            assert(held[j] != NULL);
+            *held[j] = j;
+        }
+        for (int j = 0; j < 4; ++j)
+        {
+            assert(*held[j] == j);
+            object_pool_release(pool, held[j]);
+        }
+    }
+
+    return NULL;
+}
+
+// Callback function counting acquired objects
+void count_object(void *object, void *user_data)
+{
+    (void)object;
+    ++*(size_t *)user_data;
+}
+
+int main()
+{
+    ObjectPool *pool = NULL;
+    ObjectPoolConfig config = {0};
+    config.initial_size = OBJECT_COUNT;
+    config.object_size = sizeof(int);
+    config.thread_cache_size = CACHE_SIZE;
+
+    if (!object_pool_init_ex(&pool, &config))
+    {
+        log_error("Failed to initialize object pool.");
+        return 1;
+    }
+
+    pthread_t threads[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; ++i)
+    {
+        if (pthread_create(&threads[i], NULL, cache_worker, pool) != 0)
+        {
+            log_error("Failed to create thread %d.", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < THREAD_COUNT; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Exiting threads flush their caches back to the shared free list
+    assert(pool->available == OBJECT_COUNT);
+
+    // The main thread's cache is flushed explicitly
+    void *obj = object_pool_acquire(pool);
+    assert(obj != NULL);
+    object_pool_release(pool, obj);
+    assert(pool->available < OBJECT_COUNT);
+    object_pool_thread_cache_flush(pool);
+    assert(pool->available == OBJECT_COUNT);
+
+    // Cached acquisitions are tracked like any other
+    void *held[3];
+    size_t acquired = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        held[i] = object_pool_acquire(pool);
+        assert(held[i] != NULL);
+    }
+    object_pool_iterate_acquired(pool, count_object, &acquired);
+    assert(acquired == 3);
+
+    // Double releases and foreign pointers are rejected
+    int foreign = 0;
+    object_pool_release(pool, &foreign);
+    for (int i = 0; i < 3; ++i)
+    {
+        object_pool_release(pool, held[i]);
+    }
+    object_pool_release(pool, held[0]);
+    acquired = 0;
+    object_pool_iterate_acquired(pool, count_object, &acquired);
+    assert(acquired == 0);
+    object_pool_thread_cache_flush(pool);
+    assert(pool->available == OBJECT_COUNT);
+
+    object_pool_destroy(pool);
+    printf("[INFO]: All thread cache tests passed successfully.\n");
+    return 0;
+}
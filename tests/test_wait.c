@@ -0,0 +1,133 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include "object_pool.h"
+#include "cli_logger.h"
+
+#define NUM_WAITERS 4
+#define NUM_THREADS 8
+#define ITERATIONS 2000
+
+static ObjectPool *pool = NULL;
+static int order[NUM_WAITERS];
+static _Atomic int served = 0;
+
+// Returns the current CLOCK_MONOTONIC time in milliseconds
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Blocks for the single object, records its turn and passes the object on
+static void *fifo_waiter(void *arg)
+{
+    int id = (int)(long)arg;
+    void *obj = object_pool_acquire_wait(pool);
+    assert(obj != NULL);
+    order[served++] = id;
+    object_pool_release(pool, obj);
+    return NULL;
+}
+
+// Repeatedly blocks for an object from a pool far smaller than the thread count
+static void *stress_worker(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        int *obj = object_pool_acquire_wait(pool);
+        assert(obj != NULL);
+        *obj = i;
+        object_pool_release(pool, obj);
+    }
+    return NULL;
+}
+
+// Runs the stress workers against a pool built from config
+static void run_stress(ObjectPoolConfig config)
+{
+    assert(object_pool_init_ex(&pool, &config));
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        assert(pthread_create(&threads[i], NULL, stress_worker, NULL) == 0);
+    }
+    for (int i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    assert(pool->waiter_count == 0);
+    object_pool_destroy(pool);
+}
+
+int main(void)
+{
+    log_set_level(LOG_LEVEL_ERROR);
+
+    ObjectPoolConfig config = {0};
+    config.initial_size = 1;
+    config.object_size = sizeof(int);
+    config.wait_fifo = true;
+    assert(object_pool_init_ex(&pool, &config));
+
+    // A timed acquire on an empty pool gives up after the timeout
+    void *held = object_pool_acquire(pool);
+    long long start = now_ms();
+    assert(object_pool_acquire_timed(pool, 50) == NULL);
+    assert(now_ms() - start >= 50);
+    assert(pool->waiter_count == 0);
+
+    // Waiters are served in arrival order once the object is released
+    pthread_t threads[NUM_WAITERS];
+    for (long i = 0; i < NUM_WAITERS; ++i)
+    {
+        assert(pthread_create(&threads[i], NULL, fifo_waiter, (void *)i) == 0);
+        while (pool->waiter_count != (size_t)i + 1)
+        {
+            sched_yield();
+        }
+    }
+    object_pool_release(pool, held);
+    for (int i = 0; i < NUM_WAITERS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    for (int i = 0; i < NUM_WAITERS; ++i)
+    {
+        assert(order[i] == i);
+    }
+
+    // Resizing wakes a waiter too
+    held = object_pool_acquire(pool);
+    served = 0;
+    assert(pthread_create(&threads[0], NULL, fifo_waiter, (void *)0L) == 0);
+    while (pool->waiter_count != 1)
+    {
+        sched_yield();
+    }
+    assert(object_pool_resize(pool, 2));
+    pthread_join(threads[0], NULL);
+    assert(served == 1);
+    object_pool_release(pool, held);
+    object_pool_destroy(pool);
+
+    // Many threads contending for a few objects never lose a wakeup
+    config.initial_size = 2;
+    config.wait_fifo = false;
+    run_stress(config);
+    config.wait_fifo = true;
+    run_stress(config);
+    config.mode = OBJECT_POOL_MODE_LOCK_FREE;
+    run_stress(config);
+    config.wait_fifo = false;
+    run_stress(config);
+
+    log_info("Wait test passed.");
+    return 0;
+}